@@ -0,0 +1,79 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-churn.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "simpl-bench.h"
+
+/** @brief           Alloc/free churn of a few small sizes over a live working set.
+ *  @param[in] name  Configuration name.
+ *  @param[in] flags simpl_flags of pool.
+ *  @return          0 if succeed.
+ *  @note            Best of bench_repeats rounds is reported. */
+int churn_bench(const char *name, unsigned int flags)
+{
+	const size_t buffer_size = 1U << 26, slots = 1U << 14, iterations = 1U << 22;
+	const size_t sizes[] = {16, 24, 32, 40, 48, 64, 96, 128};
+	struct simpl_stats stats;
+	void *buffer, *handle, **mem;
+	uint64_t t, best = UINT64_MAX;
+	uint32_t seed = 2018;
+	size_t i, j, k, live = 0;
+
+	buffer = malloc(buffer_size);
+	mem = (void **)malloc(slots * sizeof(void *));
+	if (!buffer || !mem || !(handle = simpl_init_ex(buffer, buffer_size, flags))) {
+		free(buffer);
+		free(mem);
+		return -1;
+	}
+	for (i = 0; i < slots; i++)
+		mem[i] = simpl_malloc(handle, sizes[bench_rand(&seed) & 7]);
+
+	for (k = 0; k < bench_repeats; k++) {
+		t = bench_now_ns();
+		for (i = 0; i < iterations; i++) {
+			j = bench_rand(&seed) & (slots - 1);
+			simpl_free(handle, mem[j]);
+			mem[j] = simpl_malloc(handle, sizes[bench_rand(&seed) & 7]);
+		}
+		t = bench_now_ns() - t;
+		if (t < best)
+			best = t;
+	}
+
+	simpl_get_stats(handle, &stats);
+	for (i = 0; i < slots; i++)
+		live += mem[i]? 1: 0;
+	printf("  %-10s %8.2f Mops/s  live %5u  available %9u  deferred %7u  largest %9u  frag %.4f\n",
+		name, iterations * 2 / (best / 1e3), (unsigned)live,
+		(unsigned)stats.available, (unsigned)stats.deferred, (unsigned)stats.largest_free,
+		1.0 - (double)stats.largest_free / (double)(stats.available + stats.deferred));
+	free(mem);
+	free(buffer);
+	return 0;
+}
@@ -0,0 +1,67 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-huge.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "simpl-bench.h"
+
+/** @brief               Time of growing one buffer by doubling realloc.
+ *  @param[in] name      Configuration name.
+ *  @param[in] threshold Huge threshold, 0 to grow inside pool.
+ *  @return              0 if succeed.
+ *  @note                A small element follows the buffer, so pool growth can't expand in place. */
+int huge_bench(const char *name, size_t threshold)
+{
+	const size_t buffer_size = (size_t)3 << 28, first = 1U << 20, last = 1U << 28;
+	void *buffer, *handle, *p = NULL;
+	uint64_t t, total = 0;
+	size_t size;
+
+	buffer = malloc(buffer_size);
+	if (!buffer || !(handle = simpl_init(buffer, buffer_size))) {
+		free(buffer);
+		return -1;
+	}
+	simpl_set_huge_threshold(handle, threshold);
+	for (size = first; size < last; size *= 2) {
+		simpl_reset(handle);
+		if (!(p = simpl_malloc(handle, size)) || !simpl_malloc(handle, 64))
+			break;
+		memset(p, 0x5a, size); /* pages present, as a filled buffer */
+		t = bench_now_ns();
+		p = simpl_realloc(handle, p, size * 2);
+		total += bench_now_ns() - t;
+		if (!p)
+			break;
+	}
+	simpl_reset(handle);
+	if (p)
+		printf("  %-10s 1MB to 256MB  %10.3f ms\n", name, (double)total / 1e6);
+	free(buffer);
+	return p? 0: -1;
+}
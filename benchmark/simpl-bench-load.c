@@ -0,0 +1,69 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-load.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "simpl-bench.h"
+
+/** @brief           Load phase of long-lived objects into a fresh pool, never freed.
+ *  @param[in] name  Configuration name.
+ *  @param[in] flags simpl_flags of pool.
+ *  @return          0 if succeed.
+ *  @note            Best of bench_repeats rounds is reported. */
+int load_bench(const char *name, unsigned int flags)
+{
+	const size_t buffer_size = 1U << 26;
+	struct simpl_stats stats;
+	void *buffer, *handle = NULL;
+	uint64_t t, best = UINT64_MAX;
+	uint32_t seed;
+	size_t k, n, loaded = 0;
+
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -1;
+	for (k = 0; k < bench_repeats; k++) {
+		if (!(handle = simpl_init_ex(buffer, buffer_size, flags))) {
+			free(buffer);
+			return -1;
+		}
+		seed = 2018;
+		t = bench_now_ns();
+		for (n = 0; simpl_malloc(handle, 16 + (bench_rand(&seed) & 0xf8)); n++)
+			continue;
+		t = bench_now_ns() - t;
+		if (t < best)
+			best = t;
+		loaded = n;
+	}
+
+	simpl_get_stats(handle, &stats);
+	printf("  %-10s %8.2f Mops/s  loaded %8u  available %9u\n",
+		name, loaded / (best / 1e3), (unsigned)loaded, (unsigned)stats.available);
+	free(buffer);
+	return 0;
+}
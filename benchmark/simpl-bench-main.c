@@ -0,0 +1,59 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-main.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "simpl.h"
+#include "simpl-bench.h"
+#include "simpl-bench-churn.c"
+#include "simpl-bench-small.c"
+#include "simpl-bench-huge.c"
+#include "simpl-bench-load.c"
+
+int main(int argc, char *argv[])
+{
+	printf("[Churn Benchmark] %s build\n", bench_build);
+	churn_bench("immediate", 0);
+	churn_bench("deferred", simpl_flag_defer_coalescing);
+	churn_bench("ordered", simpl_flag_address_ordered);
+	printf("[Small Object Benchmark] %s build\n", bench_build);
+	small_bench("immediate", 0);
+	small_bench("bestfit", simpl_flag_bestfit);
+	printf("[Huge Realloc Benchmark] %s build\n", bench_build);
+	huge_bench("pool", 0);
+	huge_bench("huge", 1U << 24);
+	printf("[Load Benchmark] %s build\n", bench_build);
+	load_bench("immediate", 0);
+	load_bench("bump", simpl_flag_bump);
+	printf("Finished!\n");
+
+	return 0;
+}
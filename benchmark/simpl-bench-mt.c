@@ -0,0 +1,341 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-mt.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* pthread_setaffinity_np */
+#endif
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200112L
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "simpl.h"
+#include "simpl-bench.h"
+
+#if defined(_WIN32)
+int main(int argc, char *argv[])
+{
+	(void)argc;
+	(void)argv;
+	printf("[Multi-thread Benchmark] needs pthreads, skipped\n");
+	return 0;
+}
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/** access patterns, cross is producer/consumer pairs which free on the other thread */
+enum mt_pattern {
+	mt_local,
+	mt_shared,
+	mt_cross,
+	mt_patterns,
+};
+
+static const char *const mt_names[mt_patterns] = {"local", "shared", "cross"};
+
+/** most threads measured */
+#define mt_max_threads (64)
+/** live elements of each churning thread, power of 2 */
+#define mt_slots (4096)
+/** buffer of SIMP per thread */
+#define mt_buffer_size ((size_t)1 << 23)
+/** in-flight elements between producer and consumer, power of 2 */
+#define mt_ring_size (1024)
+
+/** SIMP shared by threads is behind lock, NULL handle is glibc malloc */
+struct mt_pool {
+	void *buffer, *handle;
+	pthread_mutex_t lock;
+	int locked;
+};
+
+/** single producer single consumer ring */
+struct mt_ring {
+	void *slots[mt_ring_size];
+	size_t head, tail;
+};
+
+struct mt_thread {
+	pthread_t thread;
+	struct mt_pool *pool;
+	struct mt_ring *ring;
+	void **live;
+	size_t iterations;
+	uint64_t wait_ns;
+	int pattern, producer, cpu;
+};
+
+struct mt_result {
+	double mops, wait_ms, rss_mb;
+};
+
+static inline size_t mt_size(uint32_t *seed) {
+	return 16 + (bench_rand(seed) & 0xf0);
+}
+
+/** @brief            Lock SIMP, only contended lock is timed.
+ *  @param[in] pool   Locked pool.
+ *  @param[out] wait  Nanoseconds waiting for lock. */
+static void mt_lock(struct mt_pool *pool, uint64_t *wait)
+{
+	uint64_t t;
+
+	if (!pthread_mutex_trylock(&pool->lock))
+		return;
+	t = bench_now_ns();
+	pthread_mutex_lock(&pool->lock);
+	*wait += bench_now_ns() - t;
+}
+
+static void *mt_malloc(struct mt_pool *pool, size_t size, uint64_t *wait)
+{
+	void *p;
+
+	if (!pool->handle)
+		return malloc(size);
+	if (pool->locked)
+		mt_lock(pool, wait);
+	p = simpl_malloc(pool->handle, size);
+	if (pool->locked)
+		pthread_mutex_unlock(&pool->lock);
+	return p;
+}
+
+static void mt_free(struct mt_pool *pool, void *p, uint64_t *wait)
+{
+	if (!pool->handle) {
+		free(p);
+		return;
+	}
+	if (pool->locked)
+		mt_lock(pool, wait);
+	simpl_free(pool->handle, p);
+	if (pool->locked)
+		pthread_mutex_unlock(&pool->lock);
+}
+
+/** @brief           Pin calling thread to CPU.
+ *  @param[in] cpu   CPU index.
+ *  @return          0 if succeed, -1 if failed or not supported. */
+static int pin_cpu(int cpu)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set)? -1: 0;
+#else
+	(void)cpu;
+	return -1;
+#endif
+}
+
+/** @brief  Resident set size of process.
+ *  @return Bytes, 0 if not supported. */
+static size_t resident_bytes(void)
+{
+#if defined(__linux__)
+	unsigned long size, resident = 0;
+	FILE *f = fopen("/proc/self/statm", "r");
+
+	if (f) {
+		if (fscanf(f, "%lu %lu", &size, &resident) != 2)
+			resident = 0;
+		fclose(f);
+	}
+	return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+/** @brief          Churn over live elements, or produce to and consume from ring.
+ *  @param[in] arg  struct mt_thread of this thread.
+ *  @return         NULL. */
+static void *mt_worker(void *arg)
+{
+	struct mt_thread *t = (struct mt_thread *)arg;
+	struct mt_ring *ring = t->ring;
+	uint32_t seed = 2018 + (uint32_t)t->cpu;
+	size_t i, j, head, tail;
+	void *p;
+
+	pin_cpu(t->cpu);
+	if (t->pattern != mt_cross) {
+		for (i = 0; i < mt_slots; i++)
+			t->live[i] = mt_malloc(t->pool, mt_size(&seed), &t->wait_ns);
+		for (i = 0; i < t->iterations; i++) {
+			j = bench_rand(&seed) & (mt_slots - 1);
+			mt_free(t->pool, t->live[j], &t->wait_ns);
+			t->live[j] = mt_malloc(t->pool, mt_size(&seed), &t->wait_ns);
+		}
+	} else if (t->producer) {
+		for (i = 0, tail = 0; i < t->iterations; i++, tail++) {
+			p = mt_malloc(t->pool, mt_size(&seed), &t->wait_ns);
+			if (p)
+				*(volatile char *)p = 0;
+			while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) >= mt_ring_size)
+				sched_yield();
+			ring->slots[tail & (mt_ring_size - 1)] = p;
+			__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+		}
+	} else {
+		for (i = 0, head = 0; i < t->iterations; i++, head++) {
+			while (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head)
+				sched_yield();
+			p = ring->slots[head & (mt_ring_size - 1)];
+			__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+			if (p)
+				mt_free(t->pool, p, &t->wait_ns);
+		}
+	}
+	return NULL;
+}
+
+/** @brief                Run pattern on threads, SIMPs or glibc malloc.
+ *  @param[in] pattern    enum mt_pattern.
+ *  @param[in] simpl      Nonzero for SIMPL, zero for glibc malloc.
+ *  @param[in] threads    Number of threads, even for cross pattern.
+ *  @param[in] cpus       Online CPUs, threads are pinned round robin.
+ *  @param[in] iterations Iterations of each thread.
+ *  @param[out] result    Throughput, contended lock time and resident growth.
+ *  @return               0 if succeed. */
+static int mt_run(int pattern, int simpl, int threads, int cpus, size_t iterations, struct mt_result *result)
+{
+	static struct mt_thread t[mt_max_threads];
+	static struct mt_pool pools[mt_max_threads];
+	static struct mt_ring rings[mt_max_threads / 2];
+	int pool_count = pattern == mt_local? threads: pattern == mt_shared? 1: threads / 2;
+	size_t rss = resident_bytes(), buffer_size = mt_buffer_size * (pattern == mt_shared? (size_t)threads: 1);
+	uint64_t ns, wait = 0;
+	int i, j, r = -1, created = 0;
+
+	for (i = 0; i < pool_count; i++) {
+		pools[i].buffer = pools[i].handle = NULL;
+		pools[i].locked = pattern != mt_local;
+		pthread_mutex_init(&pools[i].lock, NULL);
+		if (simpl && (!(pools[i].buffer = malloc(buffer_size)) ||
+			!(pools[i].handle = simpl_init(pools[i].buffer, buffer_size))))
+			goto out;
+	}
+	for (i = 0; i < threads; i++) {
+		t[i].pool = &pools[pattern == mt_local? i: pattern == mt_shared? 0: i / 2];
+		t[i].ring = &rings[i / 2];
+		t[i].live = NULL;
+		t[i].iterations = iterations;
+		t[i].wait_ns = 0;
+		t[i].pattern = pattern;
+		t[i].producer = !(i & 1);
+		t[i].cpu = i % cpus;
+		if (pattern != mt_cross && !(t[i].live = (void **)calloc(mt_slots, sizeof(void *))))
+			goto out;
+	}
+	for (i = 0; i < threads / 2; i++)
+		rings[i].head = rings[i].tail = 0;
+
+	ns = bench_now_ns();
+	for (; created < threads; created++) {
+		if (pthread_create(&t[created].thread, NULL, mt_worker, &t[created]))
+			break;
+	}
+	for (i = 0; i < created; i++) {
+		pthread_join(t[i].thread, NULL);
+		wait += t[i].wait_ns;
+	}
+	ns = bench_now_ns() - ns;
+	if (created == threads) {
+		result->mops = (double)iterations * 2 * threads / (pattern == mt_cross? 2: 1) / (ns / 1e3);
+		result->wait_ms = wait / 1e6;
+		result->rss_mb = ((double)resident_bytes() - (double)rss) / (1 << 20);
+		r = 0;
+	}
+out:
+	for (i = 0; i < threads; i++) {
+		for (j = 0; !simpl && t[i].live && j < mt_slots; j++)
+			free(t[i].live[j]);
+		free(t[i].live);
+		t[i].live = NULL;
+	}
+	for (i = 0; i < pool_count; i++) {
+		free(pools[i].buffer);
+		pthread_mutex_destroy(&pools[i].lock);
+	}
+	return r;
+}
+
+/** @brief   Scalability of SIMPL against glibc malloc from 1 to N threads.
+ *  @note
+ *  Usage: simpl-bench-mt [threads] [iterations]
+ *  Threads double from 1 (2 for cross) up to threads, default online CPUs.
+ *  local: every thread churns its own SIMP.
+ *  shared: threads churn one SIMP behind mutex.
+ *  cross: producers allocate, consumers free, pairs share a SIMP behind mutex.
+ *  Scaling is throughput relative to the fewest threads of the pattern, lock
+ *  wait is summed over threads and counts contended locks only, rss is
+ *  resident growth while the live elements are still held. */
+int main(int argc, char *argv[])
+{
+	long online = sysconf(_SC_NPROCESSORS_ONLN);
+	int cpus = online > 0? (int)online: 1;
+	int max_threads = argc > 1? atoi(argv[1]): cpus, threads, pattern, simpl;
+	size_t iterations = argc > 2? (size_t)strtoul(argv[2], NULL, 0): (size_t)1 << 20;
+	struct mt_result result;
+	double base[2];
+
+	if (max_threads < 1)
+		max_threads = 1;
+	if (max_threads > mt_max_threads)
+		max_threads = mt_max_threads;
+	if (!iterations)
+		iterations = 1;
+	printf("[Multi-thread Benchmark] %s build, %lu iterations per thread, up to %d threads on %d CPUs\n",
+		bench_build, (unsigned long)iterations, max_threads, cpus);
+	printf("  %-7s %-7s %7s %10s %8s %13s %9s\n", "pattern", "malloc", "threads", "Mops/s", "scaling", "lock wait ms", "rss MB");
+	for (pattern = 0; pattern < mt_patterns; pattern++) {
+		base[0] = base[1] = 0;
+		for (threads = pattern == mt_cross? 2: 1; threads <= max_threads; threads *= 2) {
+			for (simpl = 1; simpl >= 0; simpl--) {
+				if (mt_run(pattern, simpl, threads, cpus, iterations, &result)) {
+					printf("  %-7s %-7s %7d failed\n", mt_names[pattern], simpl? "simpl": "glibc", threads);
+					return -1;
+				}
+				if (!base[simpl])
+					base[simpl] = result.mops;
+				printf("  %-7s %-7s %7d %10.2f %7.2fx %13.2f %9.2f\n", mt_names[pattern], simpl? "simpl": "glibc",
+					threads, result.mops, result.mops / base[simpl], result.wait_ms, result.rss_mb);
+			}
+		}
+	}
+	printf("Finished!\n");
+
+	return 0;
+}
+#endif//_WIN32
@@ -0,0 +1,113 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-small.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "simpl-bench.h"
+
+#ifdef SIMPL_LATENCY
+/** @brief               Bucket limit at percentile of latency histogram.
+ *  @param[in] histogram Histogram.
+ *  @param[in] permille  Percentile in 1/1000.
+ *  @return              Upper bound in ticks. */
+static uint64_t latency_percentile(const struct simpl_latency_histogram *histogram, uint64_t permille)
+{
+	uint64_t rank = (histogram->count * permille + 999) / 1000, seen = 0;
+	unsigned int i;
+
+	for (i = 0; i < SIMPL_LATENCY_BUCKETS - 1; i++)
+		if ((seen += histogram->buckets[i]) >= rank)
+			break;
+	return i < SIMPL_LATENCY_BUCKETS - 1? simpl_latency_bucket_limit(i): histogram->max;
+}
+#endif//SIMPL_LATENCY
+
+/** @brief           Latency of small-object malloc and free in batches.
+ *  @param[in] name  Configuration name.
+ *  @param[in] flags simpl_flags of pool.
+ *  @return          0 if succeed.
+ *  @note
+ *  1. Sizes are random in 8 ~ 1024 bytes, best of bench_repeats rounds is reported.
+ *  2. Compares pool configurations of one build, size class mapping is not
+ *     isolated, its cost is a few percent of malloc. */
+int small_bench(const char *name, unsigned int flags)
+{
+	const size_t buffer_size = 1U << 24, batch = 1U << 12, rounds = 1U << 8;
+	void *buffer, *handle, **mem;
+	uint64_t t, t_malloc, t_free, best_malloc = UINT64_MAX, best_free = UINT64_MAX;
+	uint32_t seed = 2018, *sizes;
+	size_t i, j, k;
+
+	buffer = malloc(buffer_size);
+	mem = (void **)malloc(batch * sizeof(void *));
+	sizes = (uint32_t *)malloc(batch * sizeof(uint32_t));
+	if (!buffer || !mem || !sizes || !(handle = simpl_init_ex(buffer, buffer_size, flags))) {
+		free(buffer);
+		free(mem);
+		free(sizes);
+		return -1;
+	}
+	for (i = 0; i < batch; i++)
+		sizes[i] = 8 + (bench_rand(&seed) & 1015);
+
+	for (k = 0; k < bench_repeats; k++) {
+		t_malloc = t_free = 0;
+		for (j = 0; j < rounds; j++) {
+			t = bench_now_ns();
+			for (i = 0; i < batch; i++)
+				mem[i] = simpl_malloc(handle, sizes[i]);
+			t_malloc += bench_now_ns() - t;
+			t = bench_now_ns();
+			for (i = 0; i < batch; i++)
+				simpl_free(handle, mem[(i * 2654435761U) & (batch - 1)]);
+			t_free += bench_now_ns() - t;
+		}
+		if (t_malloc < best_malloc)
+			best_malloc = t_malloc;
+		if (t_free < best_free)
+			best_free = t_free;
+	}
+
+	printf("  %-10s malloc %6.2f ns  free %6.2f ns\n", name,
+		(double)best_malloc / (batch * rounds), (double)best_free / (batch * rounds));
+#ifdef SIMPL_LATENCY
+	{
+		struct simpl_latency_histogram histograms[simpl_latency_free + 1];
+
+		if (simpl_get_latency_histograms(handle, histograms, simpl_latency_free + 1) > 0)
+			printf("  %-10s malloc p50 %llu p99 %llu p99.9 %llu max %llu ticks\n", "",
+				(unsigned long long)latency_percentile(&histograms[simpl_latency_malloc], 500),
+				(unsigned long long)latency_percentile(&histograms[simpl_latency_malloc], 990),
+				(unsigned long long)latency_percentile(&histograms[simpl_latency_malloc], 999),
+				(unsigned long long)histograms[simpl_latency_malloc].max);
+	}
+#endif//SIMPL_LATENCY
+	free(sizes);
+	free(mem);
+	free(buffer);
+	return 0;
+}
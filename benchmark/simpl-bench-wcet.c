@@ -0,0 +1,270 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench-wcet.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* sched_setaffinity */
+#endif
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <sched.h>
+#endif//__linux__
+
+#include "simpl.h"
+#include "simpl-bench.h"
+#include "src/simpl-latency.h"
+
+/** measured operations, realloc-copy is the O(n) fallback of simpl_realloc */
+enum wcet_op {
+	wcet_malloc,
+	wcet_free,
+	wcet_realloc,
+	wcet_memalign,
+	wcet_realloc_copy,
+	wcet_ops,
+};
+
+static const char *const wcet_names[wcet_ops] = {"malloc", "free", "realloc", "memalign", "realloc-copy"};
+
+/** heap sizes, the first 1MB and each 4 times of previous */
+#define wcet_heaps (4)
+/** realloc-copy samples per heap, each copies 1/8 of heap */
+#define wcet_copies (64)
+/** p99.9 ratio from the smallest to the largest heap which is reported as growth */
+#define wcet_growth (2.0)
+
+struct wcet_result {
+	uint64_t p50, p99, p999, max;
+	/** NULL results, timed but not a valid sample of the operation */
+	size_t failed;
+};
+
+/** @brief          Pin calling thread to CPU.
+ *  @param[in] cpu  CPU index.
+ *  @return         0 if succeed, -1 if failed or not supported. */
+static int pin_cpu(int cpu)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set);
+#elif defined(_WIN32)
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu)? 0: -1;
+#else
+	(void)cpu;
+	return -1;
+#endif
+}
+
+static int compare_ticks(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+	return x < y? -1: x > y;
+}
+
+static inline uint32_t clamp_ticks(uint64_t ticks) {
+	return ticks < UINT32_MAX? (uint32_t)ticks: UINT32_MAX;
+}
+
+/** @brief             Percentiles of samples, samples are sorted.
+ *  @param[in] samples Ticks of each operation.
+ *  @param[in] n       Number of samples.
+ *  @param[out] result Percentiles and max. */
+static void summarize(uint32_t *samples, size_t n, struct wcet_result *result)
+{
+	qsort(samples, n, sizeof(uint32_t), compare_ticks);
+	result->p50 = samples[(n - 1) / 2];
+	result->p99 = samples[(uint64_t)(n - 1) * 990 / 1000];
+	result->p999 = samples[(uint64_t)(n - 1) * 999 / 1000];
+	result->max = samples[n - 1];
+}
+
+/** @brief               Fill SIMP with free chunks of every size class up to 1/64 of heap,
+ *                       each free chunk is between used separators and can't coalesce.
+ *  @param[in] handle    SIMP handle.
+ *  @param[in] heap_size Buffer size of SIMP.
+ *  @return              0 if succeed. */
+static int fragment(void *handle, size_t heap_size)
+{
+	size_t cap = heap_size / 64, count = 0, size = 24, fails = 0, i;
+	void **holes, *p;
+
+	if (!(holes = (void **)malloc(cap * sizeof(void *))))
+		return -1;
+	while (count < cap && fails < 64) {
+		size = size > heap_size / 64? 24: (size + (size / 8 > 8? size / 8: 8)) & ~(size_t)7;
+		if (!(p = simpl_malloc(handle, size))) {
+			fails++;
+			continue;
+		}
+		fails = 0;
+		holes[count++] = p;
+		if (!simpl_malloc(handle, 24))
+			break;
+	}
+	for (i = 0; i < count; i++)
+		simpl_free(handle, holes[i]);
+	free(holes);
+	return count? 0: -1;
+}
+
+/** @brief                Measure every operation on fragmented SIMP of heap size.
+ *  @param[in] heap_size  Buffer size of SIMP.
+ *  @param[in] iterations Samples of each bounded operation.
+ *  @param[out] results   Results of each operation.
+ *  @return               0 if succeed. */
+static int wcet_heap(size_t heap_size, size_t iterations, struct wcet_result results[wcet_ops])
+{
+	uint32_t seed = 2018, *samples[wcet_ops - 1], copies[wcet_copies];
+	size_t i, size, align, failed[wcet_ops] = {0};
+	void *buffer, *handle, *p, *q;
+	uint64_t t;
+	int r = -1, op;
+
+	buffer = malloc(heap_size);
+	for (op = 0; op < wcet_realloc_copy; op++)
+		samples[op] = (uint32_t *)malloc(iterations * sizeof(uint32_t));
+	if (!buffer || !samples[wcet_malloc] || !samples[wcet_free] || !samples[wcet_realloc] || !samples[wcet_memalign])
+		goto out;
+	memset(buffer, 0, heap_size); /* page faults are not measured */
+	if (!(handle = simpl_init(buffer, heap_size)) || fragment(handle, heap_size))
+		goto out;
+
+	for (i = 0; i < iterations; i++) {
+		size = 8 + (bench_rand(&seed) & 2047);
+		t = simpl_latency_now();
+		p = simpl_malloc(handle, size);
+		samples[wcet_malloc][i] = clamp_ticks(simpl_latency_now() - t);
+		failed[wcet_malloc] += !p;
+		t = simpl_latency_now();
+		simpl_free(handle, p);
+		samples[wcet_free][i] = clamp_ticks(simpl_latency_now() - t);
+		failed[wcet_free] += !p;
+
+		p = simpl_malloc(handle, 8 + (bench_rand(&seed) & 2047));
+		size = 8 + (bench_rand(&seed) & 2047);
+		t = simpl_latency_now();
+		q = simpl_realloc(handle, p, size);
+		samples[wcet_realloc][i] = clamp_ticks(simpl_latency_now() - t);
+		failed[wcet_realloc] += !q;
+		simpl_free(handle, q? q: p);
+
+		align = (size_t)8 << (bench_rand(&seed) % 10);
+		size = (8 + (bench_rand(&seed) & 2047) + align - 1) & ~(align - 1); /* multiple of align */
+		t = simpl_latency_now();
+		p = simpl_memalign(handle, align, size);
+		samples[wcet_memalign][i] = clamp_ticks(simpl_latency_now() - t);
+		failed[wcet_memalign] += !p;
+		simpl_free(handle, p);
+	}
+	for (op = 0; op < wcet_realloc_copy; op++) {
+		summarize(samples[op], iterations, &results[op]);
+		results[op].failed = failed[op];
+	}
+
+	for (i = 0; i < wcet_copies; i++) { /* guarded, can't expand in place */
+		simpl_reset(handle);
+		if (!(p = simpl_malloc(handle, heap_size / 8)) || !simpl_malloc(handle, 64))
+			goto out;
+		t = simpl_latency_now();
+		q = simpl_realloc(handle, p, heap_size / 8 + 4096);
+		copies[i] = clamp_ticks(simpl_latency_now() - t);
+		if (!q)
+			goto out;
+	}
+	summarize(copies, wcet_copies, &results[wcet_realloc_copy]);
+	results[wcet_realloc_copy].failed = 0; /* aborted above */
+	r = 0;
+out:
+	for (op = 0; op < wcet_realloc_copy; op++)
+		free(samples[op]);
+	free(buffer);
+	return r;
+}
+
+/** @brief   Worst-case latency of SIMPL operations on adversarial heaps.
+ *  @note
+ *  Usage: simpl-bench-wcet [iterations] [cpu]
+ *  Every size class is populated by free chunks between used separators,
+ *  bounded operations are sampled on heaps from 1MB to 64MB. An operation
+ *  grows if its p99.9 on the largest heap is over wcet_growth times of the
+ *  smallest, max is reported but interrupts make it noisy.
+ *  Exit status is the number of operations expected O(1) which grow,
+ *  plus operations which returned NULL, whose samples time the failure path. */
+int main(int argc, char *argv[])
+{
+	static struct wcet_result results[wcet_heaps][wcet_ops];
+	size_t iterations = argc > 1? (size_t)strtoul(argv[1], NULL, 0): (size_t)1 << 20;
+	int cpu = argc > 2? atoi(argv[2]): 0, h, op, grown = 0;
+	size_t failed;
+	double ratio;
+
+	if (!iterations)
+		iterations = 1;
+	printf("[WCET Harness] %s build, %lu iterations, %s, %s\n", bench_build, (unsigned long)iterations, bench_ticks_unit,
+		pin_cpu(cpu)? "not pinned": "pinned");
+	for (h = 0; h < wcet_heaps; h++) {
+		if (wcet_heap((size_t)1 << (20 + 2 * h), iterations, results[h])) {
+			printf("  failed on %dMB heap\n", 1 << (2 * h));
+			return -1;
+		}
+	}
+	printf("  %-13s %6s %10s %10s %10s %10s %8s\n", "operation", "heap", "p50", "p99", "p99.9", "max", "failed");
+	for (op = 0; op < wcet_ops; op++) {
+		for (h = 0; h < wcet_heaps; h++)
+			printf("  %-13s %4dMB %10llu %10llu %10llu %10llu %8lu\n", wcet_names[op], 1 << (2 * h),
+				(unsigned long long)results[h][op].p50, (unsigned long long)results[h][op].p99,
+				(unsigned long long)results[h][op].p999, (unsigned long long)results[h][op].max,
+				(unsigned long)results[h][op].failed);
+	}
+	for (op = 0; op < wcet_ops; op++) {
+		for (h = 0, failed = 0; h < wcet_heaps; h++)
+			failed += results[h][op].failed;
+		if (failed) { /* NULL is timed as the rejection path, samples are not valid */
+			printf("  %-13s FAILED %lu calls, not measured\n", wcet_names[op], (unsigned long)failed);
+			grown++;
+			continue;
+		}
+		ratio = (double)results[wcet_heaps - 1][op].p999 / (double)(results[0][op].p999? results[0][op].p999: 1);
+		printf("  %-13s p99.9 x%.2f from 1MB to %dMB, max x%.2f  %s\n", wcet_names[op], ratio,
+			1 << (2 * (wcet_heaps - 1)),
+			(double)results[wcet_heaps - 1][op].max / (double)(results[0][op].max? results[0][op].max: 1),
+			ratio > wcet_growth? (op == wcet_realloc_copy? "grows (expected, copy is O(n))": "GROWS with heap size"): "bounded");
+		if (ratio > wcet_growth && op != wcet_realloc_copy)
+			grown++;
+	}
+	printf("Finished!\n");
+
+	return grown;
+}
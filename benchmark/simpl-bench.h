@@ -0,0 +1,83 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-bench.h
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_BENCH_H
+#define _SIMPL_BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "simpl.h"
+
+#ifndef bench_repeats
+#define bench_repeats (5)
+#endif//bench_repeats
+
+#if defined(SIMPL_HARDENED)
+#define bench_build "hardened"
+#elif defined(SIMPL_LATENCY)
+#define bench_build "latency"
+#else
+#define bench_build "normal"
+#endif//SIMPL_HARDENED
+
+#if defined(_WIN32)
+#include <windows.h>
+
+static inline uint64_t bench_now_ns(void) {
+	LARGE_INTEGER freq, count;
+	QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (uint64_t)((double)count.QuadPart * 1e9 / (double)freq.QuadPart);
+}
+#else
+#include <time.h>
+
+static inline uint64_t bench_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+/** unit of simpl_latency_now, timestamp of one operation */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define bench_ticks_unit "cycles"
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define bench_ticks_unit "cycles"
+#elif defined(_WIN32)
+#define bench_ticks_unit "counts"
+#else
+#define bench_ticks_unit "ns"
+#endif
+
+static inline uint32_t bench_rand(uint32_t *seed) {
+	uint32_t x = *seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *seed = x;
+}
+
+#endif//_SIMPL_BENCH_H
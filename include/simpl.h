@@ -27,11 +27,132 @@
 #define _SIMPL_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** SIMP options of simpl_init_ex. */
+enum simpl_flags {
+	/** Freed small elements are kept in exact-size quick lists,
+	 *  coalescing is deferred until a quick list grows over threshold
+	 *  or no free chunk large enough. */
+	simpl_flag_defer_coalescing = 0x1U,
+	/** Search a bounded number of chunks in the exact size class
+	 *  before good-fit, which is not strict O(1). */
+	simpl_flag_bestfit = 0x2U,
+	/** Keep the free chunk before buffer end in reserve and serve it
+	 *  last, insert free chunks by address with bounded steps. */
+	simpl_flag_address_ordered = 0x4U,
+	/** Keep tag of SIMPL element in chunk header padding and count
+	 *  live bytes per tag, 64-bit only. */
+	simpl_flag_tagged = 0x8U,
+	/** Carve allocations from the front of the free chunk before tail,
+	 *  freelists are touched only when it changes size class. For load
+	 *  phases, freed chunks are reused after the remainder runs short,
+	 *  except the quick lists of deferred coalescing which come first. */
+	simpl_flag_bump = 0x10U,
+};
+
+#ifndef SIMPL_TAGS
+/** number of tags of tagged SIMP */
+#define SIMPL_TAGS (16)
+#endif//SIMPL_TAGS
+
+/** number of buckets of latency histogram */
+#define SIMPL_LATENCY_BUCKETS (128)
+
+/** Histograms of simpl_get_latency_histograms. */
+enum simpl_latency_op {
+	simpl_latency_malloc,
+	simpl_latency_free,
+	simpl_latency_realloc,
+	simpl_latency_memalign,
+	/** simpl_realloc moved SIMPL element by copy */
+	simpl_latency_realloc_copy,
+	/** simpl_realloc merged the previous free chunk by memmove */
+	simpl_latency_realloc_merge,
+	simpl_latency_ops,
+};
+
+/** Latency histogram of an operation, in ticks of cycle counter. */
+struct simpl_latency_histogram {
+	/** operations */
+	uint64_t count;
+	/** max ticks */
+	uint64_t max;
+	/** operations per bucket, bounds by simpl_latency_bucket_limit */
+	uint64_t buckets[SIMPL_LATENCY_BUCKETS];
+};
+
+/** SIMP statistics. */
+struct simpl_stats {
+	/** bytes of free chunks in freelists */
+	size_t available;
+	/** bytes of freed chunks which coalescing is deferred */
+	size_t deferred;
+	/** size of free chunk in the highest non-empty size class */
+	size_t largest_free;
+	/** bytes mapped by huge blocks outside SIMP */
+	size_t huge;
+};
+
+/** NUMA arena statistics. */
+struct simpl_numa_stats {
+	/** pools, one per node */
+	size_t nodes;
+	/** non-zero if mbind of every node succeeded, zero on single node */
+	int bound;
+	/** free bytes of all pools */
+	size_t available;
+	/** frees from threads on other node than the owner pool */
+	size_t remote_frees;
+};
+
+/** I/O buffer of io_uring buffer pool. */
+struct simpl_uring_buffer {
+	/** page aligned, addr of fixed read and write */
+	void *data;
+	/** usable bytes, rounded up to pages */
+	size_t size;
+	/** offset of data in the registered buffer */
+	size_t offset;
+	/** buf_index of fixed read and write */
+	unsigned int index;
+};
+
+/** handle of relocatable SIMPL element, 0 is invalid */
+typedef size_t simpl_handle;
+
+/** @brief           Handler of heap corruption detected by hardened mode.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] chunk  Corrupted chunk.
+ *  @param[in] reason Description of corruption. */
+typedef void (*simpl_corruption_handler)(void *simp, void *chunk, const char *reason);
+
+/** Allocator events of trace probes and hooks. */
+enum simpl_trace_event {
+	simpl_trace_malloc,
+	simpl_trace_free,
+	simpl_trace_realloc,
+	simpl_trace_memalign,
+	/** chunk split, pointer and size of the remainder */
+	simpl_trace_split,
+	/** free neighbors merged, pointer and size of the merged chunk */
+	simpl_trace_merge,
+	/** allocation failed, requested size */
+	simpl_trace_fail,
+};
+
+/** @brief          Hook of allocator events (SIMPL_TRACE_HOOKS).
+ *  @param[in] simp  SIMP handle.
+ *  @param[in] event simpl_trace_event.
+ *  @param[in] size  Chunk size, or requested size of simpl_trace_fail.
+ *  @param[in] ptr   Payload of SIMPL element, NULL of simpl_trace_fail.
+ *  @param[in] fi    Freelist index of size, UINT32_MAX for huge blocks. */
+typedef void (*simpl_trace_hook)(void *simp, int event, size_t size, void *ptr, unsigned int fi);
+
 /** @brief                 Initialize memory buffer to SIMP.
  *  @param[in] buffer      Memory buffer for initialize.
  *  @param[in] buffer_size The Memory buffer size.
@@ -40,6 +161,25 @@ extern "C" {
  *  \p buffer_size can't over UINT32_MAX. */
 void *simpl_init(void *buffer, size_t buffer_size);
 
+/** @brief                 Initialize memory buffer to SIMP with options.
+ *  @param[in] buffer      Memory buffer for initialize.
+ *  @param[in] buffer_size The Memory buffer size.
+ *  @param[in] flags       Combination of simpl_flags.
+ *  @return                SIMP handle, NULL if simpl_flag_tagged on 32-bit.
+ *  @note
+ *  \p buffer_size can't over UINT32_MAX. */
+void *simpl_init_ex(void *buffer, size_t buffer_size, unsigned int flags);
+
+/** @brief                 Initialize SIMP with freelists sized at compile time.
+ *  @param[in] buffer      Memory buffer.
+ *  @param[in] buffer_size Memory buffer size.
+ *  @param[in] flags       Bitwise OR of simpl_flags.
+ *  @param[in] freelists   Number of freelists which index \p buffer_size, simpl::static_pool::freelists.
+ *  @return                SIMP handle, NULL if failed.
+ *  @note
+ *  Same as simpl_init_ex without sizing tables, for simpl.hpp. */
+void *simpl_init_static(void *buffer, size_t buffer_size, unsigned int flags, unsigned int freelists);
+
 /** @brief                Allocate element from SIMP.
  *  @param[in] simp       SIMP handle.
  *  @param[in] alloc_size Allocated memory size.
@@ -56,6 +196,27 @@ void *simpl_malloc(void *simp, size_t alloc_size);
  *  No lock implementation. */
 void simpl_free(void *simp, void *simple);
 
+/** @brief           Allocate zeroed SIMPL element of array.
+ *  @param[in] simp  SIMP handle.
+ *  @param[in] nmemb Number of members.
+ *  @param[in] size  Size of member.
+ *  @return          SIMPL element, NULL if out of memory or size overflow.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Large element is zeroed by non-temporal stores, which bypass cache. */
+void *simpl_calloc(void *simp, size_t nmemb, size_t size);
+
+/** @brief                Allocate element of size class folded at compile time.
+ *  @param[in] simp       SIMP handle.
+ *  @param[in] chunk_size Adjusted size, simpl::size_class<Size>::chunk_size.
+ *  @param[in] fi         Freelists index of rounded up size, simpl::size_class<Size>::index.
+ *  @return               SIMPL element.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Good-fit search starts at \p fi without mapping, other sizes or pools
+ *     with deferred coalescing or best-fit fall back to simpl_malloc. */
+void *simpl_malloc_class(void *simp, size_t chunk_size, unsigned int fi);
+
 /** @brief                  Reallocate element from SIMP.
  *  @param[in] simp         SIMP handle.
  *  @param[in] simple       SIMPL element.
@@ -63,7 +224,8 @@ void simpl_free(void *simp, void *simple);
  *  @return                  SIMPL element.
  *  @note
  *  1. No lock implementation.
- *  2. \p realloc_size can't over UINT32_MAX. */
+ *  2. \p realloc_size can't over UINT32_MAX.
+ *  3. Large element moved by non-temporal stores, which bypass cache. */
 void *simpl_realloc(void *simp, void *simple, size_t realloc_size);
 
 /** @brief                Allocate aligned element from SIMP.
@@ -76,6 +238,417 @@ void *simpl_realloc(void *simp, void *simple, size_t realloc_size);
  *  2. \p alloc_size can't over UINT32_MAX. */
 void *simpl_memalign(void *simp, size_t align, size_t alloc_size);
 
+/** @brief          Reset SIMP to its initialized state.
+ *  @param[in] simp SIMP handle.
+ *  @note
+ *  1. No lock implementation.
+ *  2. All SIMPL elements and checkpoints are dropped, cost depends on
+ *     the number of non-empty freelists, child regions and huge blocks only.
+ *  3. Children are dropped, their huge blocks are unmapped. */
+void simpl_reset(void *simp);
+
+/** @brief            Create child SIMP in an element of parent SIMP.
+ *  @param[in] parent Parent SIMP handle.
+ *  @param[in] size   Buffer size of child, taken from parent.
+ *  @return           Child SIMP handle, NULL if failed or checkpoint of parent active.
+ *  @note
+ *  1. No lock implementation, child and parent share one lock if any.
+ *  2. Child has the flags of parent. When no chunk fits, child takes
+ *     one more region of \p size from parent, not while checkpoint of
+ *     child or parent active.
+ *  3. simpl_reset keeps regions of child, simpl_pool_of of child
+ *     elements gives the registered parent, simpl_owner_of descends to
+ *     the child, simpl_free_any frees to the child. */
+void *simpl_child_create(void *parent, size_t size);
+
+/** @brief           Destroy child SIMP and give its regions back to parent.
+ *  @param[in] child Child SIMP handle.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Cost depends on the number of regions, huge blocks and siblings only,
+ *     not on the elements of child. */
+void simpl_child_destroy(void *child);
+
+/** @brief          Find innermost child SIMP holding pointer.
+ *  @param[in] simp SIMP handle.
+ *  @param[in] ptr  Pointer inside \p simp.
+ *  @return         Child or nested child whose buffer or regions hold \p ptr, \p simp if none.
+ *  @note
+ *  No lock implementation, costs the children and their regions of each level. */
+void *simpl_owner_of(void *simp, const void *ptr);
+
+/** @brief          Create a checkpoint of SIMP.
+ *  @param[in] simp SIMP handle.
+ *  @return         Checkpoint, NULL if no free chunk large enough.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Until released, SIMPL elements are allocated from the largest
+ *     free chunk only, and the elements allocated before checkpoint
+ *     can't be freed or reallocated. */
+void *simpl_mark(void *simp);
+
+/** @brief          Release all SIMPL elements allocated after checkpoint.
+ *  @param[in] simp SIMP handle.
+ *  @param[in] mark Checkpoint from simpl_mark.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Nested checkpoints created after \p mark are released too. */
+void simpl_release_to_mark(void *simp, void *mark);
+
+/** @brief           Get statistics of SIMP.
+ *  @param[in] simp  SIMP handle.
+ *  @param[out] stats Statistics.
+ *  @note
+ *  No lock implementation. */
+void simpl_get_stats(void *simp, struct simpl_stats *stats);
+
+/** @brief               Map allocations from threshold outside SIMP.
+ *  @param[in] simp      SIMP handle.
+ *  @param[in] threshold Bytes from which simpl_malloc, simpl_calloc and growing
+ *                       simpl_realloc map own pages, 0 to disable (default).
+ *  @note
+ *  1. No lock implementation.
+ *  2. Huge blocks don't fragment SIMP and may exceed UINT32_MAX,
+ *     simpl_realloc moves their pages by mremap instead of copying (Linux).
+ *  3. Huge blocks are untagged, freed by simpl_reset and simpl_release_to_mark
+ *     as SIMPL elements of the region, falls back to SIMP if mapping failed.
+ *  4. Huge blocks of SIMP of simpl_pool_create are mapped in registered
+ *     super-regions (1MB), so simpl_pool_of and simpl_free_any find them. */
+void simpl_set_huge_threshold(void *simp, size_t threshold);
+
+/** @brief             Set heap corruption handler of hardened mode (SIMPL_HARDENED).
+ *  @param[in] handler Corruption handler, NULL to report by stderr and abort.
+ *  @note
+ *  1. Hardened mode XORs chunk headers with a cookie, detects double free,
+ *     and validates physical and freelist neighbors before they are used.
+ *     Cookie mixes chunk address with a per-process random secret
+ *     (AT_RANDOM on Linux, ASLR addresses elsewhere).
+ *  2. Checks cost more than 5%: churn benchmark lost about 10% (ordered),
+ *     20% (immediate) and 30% (deferred), neighbor checks are the most.
+ *  3. If handler returns, the corrupted free or realloc is skipped,
+ *     pool is undefined after other corruptions.
+ *  4. Do nothing when not hardened. */
+void simpl_set_corruption_handler(simpl_corruption_handler handler);
+
+/** @brief          Set hook of allocator events, compiled in by SIMPL_TRACE_HOOKS.
+ *  @param[in] hook Trace hook, NULL to detach.
+ *  @note
+ *  1. USDT probes simpl:malloc, free, realloc, memalign, split, merge and fail
+ *     carry the same (simp, size, ptr, fi) on ELF x86-64 and AArch64,
+ *     e.g. bpftrace -e 'usdt:./libsimpl.so:simpl:fail { @[arg1] = count(); }'.
+ *     Each probe is a nop behind the test of its stapsdt semaphore, arguments
+ *     are computed only while a tracer is attached. SIMPL_NO_USDT removes them.
+ *  2. Hook is called synchronously inside allocator, it must not call SIMPL.
+ *  3. Do nothing when not compiled with SIMPL_TRACE_HOOKS. */
+void simpl_set_trace_hook(simpl_trace_hook hook);
+
+/** @brief                Copy latency histograms of SIMP, compiled in by SIMPL_LATENCY.
+ *  @param[in] simp        SIMP handle.
+ *  @param[out] histograms Histograms indexed by simpl_latency_op.
+ *  @param[in] ops         Number of \p histograms.
+ *  @return                Histograms copied, -ENOTSUP if not compiled with SIMPL_LATENCY,
+ *                         -ENOSPC if SIMP is too small for histograms.
+ *  @note
+ *  1. No lock implementation.
+ *  2. simpl_malloc, simpl_free, simpl_realloc and simpl_memalign are timed
+ *     by rdtsc on x86 or monotonic clock in nanoseconds. simpl_calloc (with its
+ *     zeroing), simpl_malloc_tagged and simpl_malloc_class are recorded as
+ *     simpl_latency_malloc, frees by other API which call simpl_free as
+ *     simpl_latency_free. Relocatable elements, simpl_reserve and child pool
+ *     growth are not timed. Slow paths of simpl_realloc are also recorded in
+ *     simpl_latency_realloc_copy and simpl_latency_realloc_merge.
+ *  3. Histograms are kept by simpl_reset, cleared by simpl_init. They take
+ *     about 6KB of SIMP, pools smaller than 64 times of it are not timed. */
+int simpl_get_latency_histograms(void *simp, struct simpl_latency_histogram *histograms, unsigned int ops);
+
+/** @brief            Upper bound of latency histogram bucket.
+ *  @param[in] bucket Bucket index.
+ *  @return           Exclusive upper bound in ticks, UINT64_MAX of the last bucket.
+ *  @note
+ *  Buckets are exact below 8 ticks, then 4 per power of two (error under 25%). */
+uint64_t simpl_latency_bucket_limit(unsigned int bucket);
+
+/** @brief                Allocate tagged SIMPL element.
+ *  @param[in] simp       SIMP handle.
+ *  @param[in] alloc_size Size of SIMPL element.
+ *  @param[in] tag        Tag less than SIMPL_TAGS, elements of simpl_malloc are tag 0.
+ *  @return               SIMPL element, NULL if out of memory or over tag budget.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Tag is ignored if SIMP not initialized with simpl_flag_tagged.
+ *  3. Tag follows the element through simpl_realloc. */
+void *simpl_malloc_tagged(void *simp, size_t alloc_size, unsigned int tag);
+
+/** @brief          Get live bytes of tag, include chunk rounding.
+ *  @param[in] simp SIMP handle.
+ *  @param[in] tag  Tag less than SIMPL_TAGS.
+ *  @return         Live bytes, 0 if SIMP not tagged.
+ *  @note
+ *  No lock implementation. */
+size_t simpl_tag_usage(void *simp, unsigned int tag);
+
+/** @brief            Limit live bytes of tag.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] tag    Tag less than SIMPL_TAGS.
+ *  @param[in] budget Max live bytes, 0 for unlimited.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Allocation or growth over budget fails, live elements are kept. */
+void simpl_set_tag_budget(void *simp, unsigned int tag, size_t budget);
+
+/** @brief               Create NUMA arena, one locked SIMP per node.
+ *  @param[in] node_size Buffer size of each node, can't over UINT32_MAX.
+ *  @param[in] flags     Combination of simpl_flags for each SIMP.
+ *  @return              NUMA arena, NULL if out of memory.
+ *  @note
+ *  1. Buffer of node is bound by mbind before SIMP touches it (Linux),
+ *     falls back to one node from malloc on other platforms.
+ *  2. Thread safe, unlike SIMP. */
+void *simpl_numa_create(size_t node_size, unsigned int flags);
+
+/** @brief          Destroy NUMA arena and release buffers of all nodes.
+ *  @param[in] numa NUMA arena. */
+void simpl_numa_destroy(void *numa);
+
+/** @brief                Allocate from SIMP of calling thread's node.
+ *  @param[in] numa       NUMA arena.
+ *  @param[in] alloc_size Size of SIMPL element.
+ *  @return               SIMPL element, NULL if all nodes out of memory.
+ *  @note                 Spills to other nodes when the local node is full. */
+void *simpl_numa_malloc(void *numa, size_t alloc_size);
+
+/** @brief            Free SIMPL element to its owner node.
+ *  @param[in] numa   NUMA arena.
+ *  @param[in] simple SIMPL element of simpl_numa_malloc. */
+void simpl_numa_free(void *numa, void *simple);
+
+/** @brief           Get statistics of NUMA arena.
+ *  @param[in] numa  NUMA arena.
+ *  @param[out] stats Statistics. */
+void simpl_numa_get_stats(void *numa, struct simpl_numa_stats *stats);
+
+/** @brief               Create SIMP in registered super-regions.
+ *  @param[in] pool_size Size of SIMP, can't over UINT32_MAX.
+ *  @param[in] flags     Combination of simpl_flags.
+ *  @return              SIMP handle, NULL if out of memory.
+ *  @note
+ *  1. Memory is mapped aligned to 1 << SIMPL_REGISTRY_SHIFT bytes (1MB),
+ *     each aligned super-region belongs to one SIMP only.
+ *  2. Thread safe, the SIMP itself is not. */
+void *simpl_pool_create(size_t pool_size, unsigned int flags);
+
+/** @brief          Unregister SIMP of simpl_pool_create and release its memory.
+ *  @param[in] simp SIMP handle.
+ *  @note
+ *  Huge blocks of SIMP and its children are unmapped as simpl_reset. */
+void simpl_pool_destroy(void *simp);
+
+/** @brief         Find owner SIMP of pointer in O(1) by two-level radix table.
+ *  @param[in] ptr Any pointer.
+ *  @return        SIMP handle, NULL if not inside SIMP of simpl_pool_create.
+ *  @note
+ *  Lock free, SIMP creation must happen before lookups of its elements,
+ *  which holds when elements are passed between threads. */
+void *simpl_pool_of(const void *ptr);
+
+/** @brief            Free SIMPL element without its SIMP handle.
+ *  @param[in] simple SIMPL element of SIMP of simpl_pool_create.
+ *  @return           0 if freed or NULL, -ENOENT if not owned by any SIMP.
+ *  @note
+ *  1. No lock implementation, as simpl_free on owner SIMP.
+ *  2. -ENOENT lets a global free() shim fall back to system allocator.
+ *  3. Elements of child SIMPs are freed to the child by simpl_owner_of. */
+int simpl_free_any(void *simple);
+
+/** @brief                Allocate relocatable SIMPL element.
+ *  @param[in] simp       SIMP handle.
+ *  @param[in] alloc_size Size of SIMPL element.
+ *  @return               Handle, 0 if out of memory.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Element costs one pointer more than simpl_malloc, handle table
+ *     is allocated from SIMP and grows by doubling.
+ *  3. Element can be moved by simpl_compact unless locked. */
+simpl_handle simpl_halloc(void *simp, size_t alloc_size);
+
+/** @brief            Pin relocatable SIMPL element.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] handle Handle of simpl_halloc.
+ *  @return           SIMPL element, valid until the last simpl_hunlock.
+ *  @note             Locks are counted, element must not be freed or reallocated by pointer. */
+void *simpl_hlock(void *simp, simpl_handle handle);
+
+/** @brief            Unpin relocatable SIMPL element.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] handle Handle of simpl_halloc. */
+void simpl_hunlock(void *simp, simpl_handle handle);
+
+/** @brief            Free relocatable SIMPL element.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] handle Handle of simpl_halloc. */
+void simpl_hfree(void *simp, simpl_handle handle);
+
+/** @brief            Incremental compaction step.
+ *  @param[in] simp   SIMP handle.
+ *  @param[in] budget Bytes to spend, each visited chunk costs a chunk header,
+ *                    each moved element costs its size.
+ *  @return           Bytes moved.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Unlocked relocatable elements slide down into the free chunk before them,
+ *     free space merges toward high addresses. Next step resumes where this one stopped,
+ *     one full pass leaves no free chunk before an unlocked relocatable element.
+ *  3. Do nothing while any checkpoint is active. */
+size_t simpl_compact(void *simp, size_t budget);
+
+/** @brief              Give free tail of SIMP back to the caller.
+ *  @param[in] simp      SIMP handle.
+ *  @param[out] new_size Bytes from \p simp still used by SIMP, can be NULL.
+ *  @return              Bytes trimmed from the end by this call.
+ *  @note
+ *  1. No lock implementation.
+ *  2. If the last chunk is free, it's removed or shrunk and the tail chunk
+ *     moves down, memory after (uint8_t *)simp + *new_size can be unmapped,
+ *     reallocated in place or used by other SIMP. \p simp is buffer of simpl_init
+ *     if buffer is pointer aligned.
+ *  3. Deferred chunks are coalesced first, do nothing while any checkpoint is active. */
+size_t simpl_trim(void *simp, size_t *new_size);
+
+/** @brief              Pre-carve free chunks for a known object size.
+ *  @param[in] simp     SIMP handle.
+ *  @param[in] size     Size of SIMPL elements to be served.
+ *  @param[in] count    Number of chunks.
+ *  @param[in] prefault Non-zero to touch pages of the chunks.
+ *  @return             Chunks carved, less than \p count if the largest free chunk is short.
+ *  @note
+ *  1. No lock implementation.
+ *  2. The largest free chunk is split in one pass into chunks rounded up to
+ *     their size class, pushed to its freelist, so first simpl_malloc of
+ *     \p size don't search or fault pages, nor split unless the rounding
+ *     is over a minimal chunk (sizes from 2KB).
+ *  3. Carved chunks are free neighbors, coalesced again when one of them is freed,
+ *     by simpl_compact or simpl_trim. */
+size_t simpl_reserve(void *simp, size_t size, size_t count, int prefault);
+
+/** @brief            Initialize granule SIMP, chunk metadata kept out of band.
+ *  @param[in] buffer  Memory buffer, pointer aligned.
+ *  @param[in] size    Size of buffer.
+ *  @param[in] granule Unit of allocation, power of 2, e.g. 4096 for pages.
+ *  @return            Granule SIMP handle, NULL if buffer too small or granule invalid.
+ *  @note
+ *  1. Size of each run of granules is kept in a side table at the front of
+ *     \p buffer (size array, boundary and used bitmaps), payloads follow
+ *     aligned to \p granule without header, so elements are exactly aligned.
+ *  2. Side table costs 12 bytes and 2 bits per granule, merging on free
+ *     touches the side table only.
+ *  3. No lock implementation. */
+void *simpl_oob_init(void *buffer, size_t size, size_t granule);
+
+/** @brief                Allocate granules.
+ *  @param[in] oob        Granule SIMP handle.
+ *  @param[in] alloc_size Size of SIMPL element, rounded up to granules.
+ *  @return               SIMPL element aligned to granule, NULL if out of memory. */
+void *simpl_oob_malloc(void *oob, size_t alloc_size);
+
+/** @brief                Allocate granules aligned to \p alignment.
+ *  @param[in] oob        Granule SIMP handle.
+ *  @param[in] alignment  Power of 2, up to granule costs nothing.
+ *  @param[in] alloc_size Size of SIMPL element, rounded up to granules.
+ *  @return               SIMPL element, NULL if out of memory or alignment invalid.
+ *  @note                 Granules skipped before element stay free. */
+void *simpl_oob_memalign(void *oob, size_t alignment, size_t alloc_size);
+
+/** @brief            Free granules, coalesced with free neighbors.
+ *  @param[in] oob    Granule SIMP handle.
+ *  @param[in] simple SIMPL element of granule SIMP.
+ *  @note             Pointer which is not a used element, e.g. freed twice, is ignored. */
+void simpl_oob_free(void *oob, void *simple);
+
+/** @brief            Usable size of element.
+ *  @param[in] oob    Granule SIMP handle.
+ *  @param[in] simple SIMPL element of granule SIMP.
+ *  @return           Bytes of its granules, 0 if not a used element. */
+size_t simpl_oob_usable_size(void *oob, const void *simple);
+
+/** @brief            Get statistics of granule SIMP.
+ *  @param[in] oob    Granule SIMP handle.
+ *  @param[out] stats Statistics, deferred and huge are 0. */
+void simpl_oob_get_stats(void *oob, struct simpl_stats *stats);
+
+/** @brief               Create I/O buffer pool registered to io_uring.
+ *  @param[in] ring_fd   File descriptor of io_uring, negative for a pool not registered.
+ *  @param[in] pool_size Bytes of pool, rounded up to pages.
+ *  @return              Pool handle, NULL if out of memory or registration failed (errno kept).
+ *  @note
+ *  1. Pages are mapped and registered as buffer 0 by io_uring_register
+ *     IORING_REGISTER_BUFFERS, raw syscall without liburing. Ring must have
+ *     no registered buffers, size is limited to 1GB and RLIMIT_MEMLOCK by kernel.
+ *  2. Granule SIMP of pages (simpl_oob_init) serves the buffers, Linux only.
+ *  3. No lock implementation. */
+void *simpl_uring_create(int ring_fd, size_t pool_size);
+
+/** @brief           Unregister buffers of ring and unmap pool.
+ *  @param[in] uring Pool handle. */
+void simpl_uring_destroy(void *uring);
+
+/** @brief                Allocate page aligned I/O buffer.
+ *  @param[in] uring      Pool handle.
+ *  @param[in] alloc_size Bytes of I/O buffer.
+ *  @param[out] buffer    Address, usable size, index and offset for fixed read and write.
+ *  @return               0 if succeed, -EINVAL or -ENOMEM if failed. */
+int simpl_uring_malloc(void *uring, size_t alloc_size, struct simpl_uring_buffer *buffer);
+
+/** @brief           Free I/O buffer.
+ *  @param[in] uring Pool handle.
+ *  @param[in] data  Address of I/O buffer.
+ *  @note            I/O on the buffer must be completed. */
+void simpl_uring_free(void *uring, void *data);
+
+/** @brief            Get statistics of I/O buffer pool.
+ *  @param[in] uring  Pool handle.
+ *  @param[out] stats Statistics. */
+void simpl_uring_get_stats(void *uring, struct simpl_stats *stats);
+
+/** @brief          Write binary map of SIMP for offline analysis.
+ *  @param[in] simp SIMP handle.
+ *  @param[in] fd   File descriptor.
+ *  @return         0 if succeed, negative errno if failed.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Physical chunks (offset, size, flags, tag), bitmaps and list lengths
+ *     are written without allocation, cheap enough after a failed allocation.
+ *  3. Read by tools/simpl-analyze. */
+int simpl_snapshot(void *simp, int fd);
+
+/** @brief                 Start sampling heap profile of SIMP.
+ *  @param[in] simp          SIMP handle.
+ *  @param[in] sample_period Average bytes allocated between samples.
+ *  @param[in] max_samples   Max live samples, later samples are dropped.
+ *  @return                0 if succeed, -EINVAL, -EBUSY if already started,
+ *                         -ENOMEM if sample table can't be allocated.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Sample table is allocated from SIMP, about one SIMPL element per
+ *     \p sample_period bytes records its call stack (glibc and Windows only).
+ *  3. Sample is dropped when SIMPL element freed, simpl_reset stops profile. */
+int simpl_profile_start(void *simp, size_t sample_period, size_t max_samples);
+
+/** @brief          Stop heap profile and free sample table.
+ *  @param[in] simp SIMP handle.
+ *  @note
+ *  No lock implementation. */
+void simpl_profile_stop(void *simp);
+
+/** @brief          Write live samples as pprof legacy heap profile.
+ *  @param[in] simp SIMP handle.
+ *  @param[in] fd   File descriptor.
+ *  @return         0 if succeed, negative errno if failed.
+ *  @note
+ *  1. No lock implementation.
+ *  2. Read by "pprof --inuse_space <program> <file>", heap_v2 header
+ *     tells pprof the period to scale samples back. */
+int simpl_profile_dump(void *simp, int fd);
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,155 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl.hpp
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_HPP
+#define _SIMPL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "simpl.h"
+
+namespace simpl {
+
+/** compile-time mirror of size class mapping in simpl.c */
+namespace detail {
+
+constexpr std::size_t bytes_per_ptr = sizeof(void *);
+/** simplc_chunk_min_size, free links and previous physical chunk */
+constexpr std::size_t chunk_min_size = 3 * sizeof(void *);
+/** simplc_max_freelists */
+constexpr unsigned int max_freelists = 24 * 8;
+
+constexpr unsigned int fls(std::uint64_t x) {
+	return x? 1 + fls(x >> 1): 0;
+}
+
+constexpr unsigned int shift(std::uint64_t size) {
+	return 2 + ((size >= 4096) + (size >= (1U << 22))) * 10;
+}
+
+constexpr unsigned int index(std::uint64_t size, std::uint64_t v, unsigned int ls) {
+	return (((size >= 4096) + (size >= (1U << 22))) * 8 + (ls > 3? ls - 3: 0)) << 3 |
+		(unsigned int)((v >> (ls > 4? ls - 4: 0)) & 7);
+}
+
+/** freelists_mapping */
+constexpr unsigned int mapping(std::uint64_t size) {
+	return index(size, size >> shift(size), fls(size >> shift(size)));
+}
+
+constexpr std::uint64_t granule(std::uint64_t size) {
+	return (std::uint64_t)1 << (shift(size) + (fls(size >> shift(size)) > 4? fls(size >> shift(size)) - 4: 0));
+}
+
+/** roundup_mapping, 0 if rounded over UINT32_MAX */
+constexpr unsigned int roundup_mapping(std::uint64_t size) {
+	return ((size + granule(size) - 1) & ~(granule(size) - 1)) > UINT32_MAX? 0:
+		mapping((size + granule(size) - 1) & ~(granule(size) - 1));
+}
+
+/** adjust_alloc_size of pointer alignment */
+constexpr std::size_t adjust(std::size_t size) {
+	return ((size < chunk_min_size? chunk_min_size: size) + bytes_per_ptr - 1) & ~(bytes_per_ptr - 1);
+}
+
+} // namespace detail
+
+/** Size class of SIMPL element folded at compile time. */
+template <std::size_t Size>
+struct size_class {
+	static_assert(Size > 0 && Size <= UINT32_MAX, "SIMPL element is 1 to UINT32_MAX bytes");
+	/** adjusted chunk size */
+	static constexpr std::size_t chunk_size = detail::adjust(Size);
+	/** freelists index where good-fit search starts */
+	static constexpr unsigned int index = detail::roundup_mapping(chunk_size);
+};
+
+/** <pre>
+ *  SIMP in an aligned array of the object, tables sized at compile time.
+ *  Construction is constant, so a pool in static storage costs nothing at
+ *  startup and on stack only a pointer is written. SIMP is initialized by
+ *  the first allocation, without sizing its tables.
+ *  No lock implementation, same as SIMP. </pre> */
+template <std::size_t Bytes, unsigned int Flags = 0>
+class static_pool {
+	static_assert(Bytes >= 1024 && Bytes <= UINT32_MAX, "SIMP buffer is 1KB to UINT32_MAX bytes");
+
+public:
+	/** freelists which index the whole buffer, est of simpl_init */
+	static constexpr unsigned int freelists = detail::mapping(Bytes) + 1;
+	/** bytes of second level bitmaps */
+	static constexpr std::size_t sl_bitmaps = (freelists + 7) / 8;
+	static_assert(freelists <= detail::max_freelists, "freelists over simplc_max_freelists");
+
+	constexpr static_pool() noexcept: handle_(nullptr), none_(0) {}
+	static_pool(const static_pool &) = delete;
+	static_pool &operator=(const static_pool &) = delete;
+
+	/** @brief  SIMP handle, initialized at first call.
+	 *  @return SIMP handle for C API. */
+	void *handle() noexcept {
+		return handle_? handle_: (handle_ = simpl_init_static(storage_, Bytes, Flags, freelists));
+	}
+
+	void *malloc(std::size_t size) noexcept {
+		return simpl_malloc(handle(), size);
+	}
+
+	/** @brief  Allocate element of constant size, size class folded at compile time.
+	 *  @return SIMPL element. */
+	template <std::size_t Size>
+	void *malloc() noexcept {
+		return simpl_malloc_class(handle(), size_class<Size>::chunk_size, size_class<Size>::index);
+	}
+
+	void free(void *simple) noexcept {
+		if (handle_)
+			simpl_free(handle_, simple);
+	}
+
+	void *realloc(void *simple, std::size_t size) noexcept {
+		return simpl_realloc(handle(), simple, size);
+	}
+
+	void *memalign(std::size_t align, std::size_t size) noexcept {
+		return simpl_memalign(handle(), align, size);
+	}
+
+	void reset() noexcept {
+		if (handle_)
+			simpl_reset(handle_);
+	}
+
+private:
+	void *handle_;
+	union {
+		alignas(std::max_align_t) unsigned char storage_[Bytes];
+		char none_;
+	};
+};
+
+} // namespace simpl
+
+#endif//_SIMPL_HPP
@@ -0,0 +1,179 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-bulk.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "simpl-bulk.h"
+
+#if defined(__x86_64__) && defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define bulk_sse2
+#define bulk_target_avx2 __attribute__((target("avx2")))
+#define bulk_has_avx2() __builtin_cpu_supports("avx2")
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define bulk_sse2
+#define bulk_target_avx2
+static int bulk_has_avx2(void) {
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7)
+		return 0;
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27 | 1 << 28)) != (1 << 27 | 1 << 28) || (_xgetbv(0) & 6) != 6)
+		return 0; /* OSXSAVE and AVX, YMM state enabled by OS */
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 5)) != 0;
+}
+#endif
+
+/** bytes prefetched ahead of copy */
+#define bulk_prefetch_distance (512)
+
+#ifdef bulk_sse2
+/** -1 unknown, 0 SSE2, 1 AVX2, racing initialization is harmless */
+static int bulk_level = -1;
+
+static inline int bulk_use_avx2(void) {
+	if (bulk_level < 0)
+		bulk_level = bulk_has_avx2()? 1: 0;
+	return bulk_level;
+}
+
+/** @brief         Copy head bytes until \p dst aligned.
+ *  @param[in] dst   Destination.
+ *  @param[in] src   Source.
+ *  @param[in] n     Bytes.
+ *  @param[in] align Alignment of stores.
+ *  @return          Bytes copied. */
+static inline size_t bulk_align_head(uint8_t *dst, const uint8_t *src, size_t n, size_t align)
+{
+	size_t head = (align - ((uintptr_t)dst & (align - 1))) & (align - 1);
+
+	if (head > n)
+		head = n;
+	memmove(dst, src, head);
+	return head;
+}
+
+bulk_target_avx2
+static void bulk_copy_avx2(uint8_t *dst, const uint8_t *src, size_t n)
+{
+	__m256i a, b;
+	size_t i = bulk_align_head(dst, src, n, 32);
+
+	for (; i + 64 <= n; i += 64) { /* loads before stores, safe when dst < src */
+		_mm_prefetch((const char *)src + i + bulk_prefetch_distance, _MM_HINT_NTA);
+		a = _mm256_loadu_si256((const __m256i *)(src + i));
+		b = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+		_mm256_stream_si256((__m256i *)(dst + i), a);
+		_mm256_stream_si256((__m256i *)(dst + i + 32), b);
+	}
+	_mm_sfence();
+	memmove(dst + i, src + i, n - i);
+}
+
+static void bulk_copy_sse2(uint8_t *dst, const uint8_t *src, size_t n)
+{
+	__m128i a, b, c, d;
+	size_t i = bulk_align_head(dst, src, n, 16);
+
+	for (; i + 64 <= n; i += 64) {
+		_mm_prefetch((const char *)src + i + bulk_prefetch_distance, _MM_HINT_NTA);
+		a = _mm_loadu_si128((const __m128i *)(src + i));
+		b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+		c = _mm_loadu_si128((const __m128i *)(src + i + 32));
+		d = _mm_loadu_si128((const __m128i *)(src + i + 48));
+		_mm_stream_si128((__m128i *)(dst + i), a);
+		_mm_stream_si128((__m128i *)(dst + i + 16), b);
+		_mm_stream_si128((__m128i *)(dst + i + 32), c);
+		_mm_stream_si128((__m128i *)(dst + i + 48), d);
+	}
+	_mm_sfence();
+	memmove(dst + i, src + i, n - i);
+}
+
+bulk_target_avx2
+static void bulk_zero_avx2(uint8_t *dst, size_t n)
+{
+	const __m256i z = _mm256_setzero_si256();
+	size_t i = (32 - ((uintptr_t)dst & 31)) & 31;
+
+	if (i > n)
+		i = n;
+	memset(dst, 0, i);
+	for (; i + 64 <= n; i += 64) {
+		_mm256_stream_si256((__m256i *)(dst + i), z);
+		_mm256_stream_si256((__m256i *)(dst + i + 32), z);
+	}
+	_mm_sfence();
+	memset(dst + i, 0, n - i);
+}
+
+static void bulk_zero_sse2(uint8_t *dst, size_t n)
+{
+	const __m128i z = _mm_setzero_si128();
+	size_t i = (16 - ((uintptr_t)dst & 15)) & 15;
+
+	if (i > n)
+		i = n;
+	memset(dst, 0, i);
+	for (; i + 64 <= n; i += 64) {
+		_mm_stream_si128((__m128i *)(dst + i), z);
+		_mm_stream_si128((__m128i *)(dst + i + 16), z);
+		_mm_stream_si128((__m128i *)(dst + i + 32), z);
+		_mm_stream_si128((__m128i *)(dst + i + 48), z);
+	}
+	_mm_sfence();
+	memset(dst + i, 0, n - i);
+}
+#endif//bulk_sse2
+
+void simpl_bulk_copy_nt(void *dst, const void *src, size_t n)
+{
+#ifdef bulk_sse2
+	if (bulk_use_avx2())
+		bulk_copy_avx2((uint8_t *)dst, (const uint8_t *)src, n);
+	else
+		bulk_copy_sse2((uint8_t *)dst, (const uint8_t *)src, n);
+#else
+	memmove(dst, src, n);
+#endif//bulk_sse2
+}
+
+void simpl_bulk_zero_nt(void *dst, size_t n)
+{
+#ifdef bulk_sse2
+	if (bulk_use_avx2())
+		bulk_zero_avx2((uint8_t *)dst, n);
+	else
+		bulk_zero_sse2((uint8_t *)dst, n);
+#else
+	memset(dst, 0, n);
+#endif//bulk_sse2
+}
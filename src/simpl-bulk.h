@@ -0,0 +1,69 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-bulk.h
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_BULK_H
+#define _SIMPL_BULK_H
+
+#include <stddef.h>
+#include <string.h>
+
+#ifndef SIMPL_BULK_THRESHOLD
+/** bytes from which copy and zero bypass cache by non-temporal stores */
+#define SIMPL_BULK_THRESHOLD (1U << 20)
+#endif//SIMPL_BULK_THRESHOLD
+
+/** @brief         Copy large block with non-temporal stores.
+ *  @param[in] dst Destination, lower than \p src if overlapped.
+ *  @param[in] src Source.
+ *  @param[in] n   Bytes. */
+void simpl_bulk_copy_nt(void *dst, const void *src, size_t n);
+
+/** @brief         Zero large block with non-temporal stores.
+ *  @param[in] dst Destination.
+ *  @param[in] n   Bytes. */
+void simpl_bulk_zero_nt(void *dst, size_t n);
+
+/** @brief         Forward copy, cache bypassed above SIMPL_BULK_THRESHOLD.
+ *  @param[in] dst Destination, lower than \p src if overlapped.
+ *  @param[in] src Source.
+ *  @param[in] n   Bytes. */
+static inline void simpl_bulk_copy(void *dst, const void *src, size_t n) {
+	if (n < SIMPL_BULK_THRESHOLD)
+		memmove(dst, src, n);
+	else
+		simpl_bulk_copy_nt(dst, src, n);
+}
+
+/** @brief         Zero, cache bypassed above SIMPL_BULK_THRESHOLD.
+ *  @param[in] dst Destination.
+ *  @param[in] n   Bytes. */
+static inline void simpl_bulk_zero(void *dst, size_t n) {
+	if (n < SIMPL_BULK_THRESHOLD)
+		memset(dst, 0, n);
+	else
+		simpl_bulk_zero_nt(dst, n);
+}
+
+#endif//_SIMPL_BULK_H
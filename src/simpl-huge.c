@@ -0,0 +1,108 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-huge.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "simpl-huge.h"
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#include <sys/mman.h>
+#define huge_mapped
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif//_WIN32
+
+#ifdef huge_mapped
+/** @brief             Round up to pages.
+ *  @param[in,out] size Bytes.
+ *  @return             0 if overflow. */
+static int huge_roundup(size_t *size)
+{
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+	if (*size > SIZE_MAX - page)
+		return 0;
+	*size = (*size + page - 1) & ~(page - 1);
+	return 1;
+}
+#endif//huge_mapped
+
+void *simpl_huge_map(size_t *size)
+{
+#ifdef huge_mapped
+	void *map;
+
+	if (!huge_roundup(size))
+		return NULL;
+	map = mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return map == MAP_FAILED? NULL: map;
+#else
+	(void)size;
+	return NULL;
+#endif//huge_mapped
+}
+
+void *simpl_huge_remap(void *map, size_t old_size, size_t *size)
+{
+#ifdef huge_mapped
+	void *new_map;
+
+	if (!huge_roundup(size))
+		return NULL;
+	if (*size == old_size)
+		return map;
+#ifdef MREMAP_MAYMOVE
+	new_map = mremap(map, old_size, *size, MREMAP_MAYMOVE); /* page tables moved, no copy */
+	return new_map == MAP_FAILED? NULL: new_map;
+#else
+	if (!(new_map = simpl_huge_map(size)))
+		return NULL;
+	memcpy(new_map, map, old_size < *size? old_size: *size);
+	munmap(map, old_size);
+	return new_map;
+#endif//MREMAP_MAYMOVE
+#else
+	(void)map;
+	(void)old_size;
+	(void)size;
+	return NULL;
+#endif//huge_mapped
+}
+
+void simpl_huge_unmap(void *map, size_t size)
+{
+#ifdef huge_mapped
+	munmap(map, size);
+#else
+	(void)map;
+	(void)size;
+#endif//huge_mapped
+}
@@ -0,0 +1,67 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-huge.h
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_HUGE_H
+#define _SIMPL_HUGE_H
+
+#include <stddef.h>
+
+/** @brief             Map zeroed pages for huge block.
+ *  @param[in,out] size Bytes required, rounded up to pages.
+ *  @return             Mapping, NULL if failed or not supported. */
+void *simpl_huge_map(size_t *size);
+
+/** @brief             Resize mapping, pages moved instead of copied if possible.
+ *  @param[in] map      Mapping.
+ *  @param[in] old_size Bytes of mapping.
+ *  @param[in,out] size Bytes required, rounded up to pages.
+ *  @return             Mapping which may moved, NULL if failed and \p map kept. */
+void *simpl_huge_remap(void *map, size_t old_size, size_t *size);
+
+/** @brief          Unmap huge block.
+ *  @param[in] map  Mapping.
+ *  @param[in] size Bytes of mapping. */
+void simpl_huge_unmap(void *map, size_t size);
+
+/** @brief             Map huge block in super-regions registered to owner (simpl-registry.c).
+ *  @param[in] owner    SIMP of the huge block, found by simpl_pool_of of the block.
+ *  @param[in,out] size Bytes required, rounded up to super-regions.
+ *  @return             Mapping aligned to super-region, NULL if failed or not supported. */
+void *simpl_registry_map_huge(void *owner, size_t *size);
+
+/** @brief             Resize registered huge block, pages moved to new super-regions.
+ *  @param[in] owner    SIMP of the huge block.
+ *  @param[in] map      Mapping of simpl_registry_map_huge.
+ *  @param[in] old_size Bytes of mapping.
+ *  @param[in,out] size Bytes required, rounded up to super-regions.
+ *  @return             Mapping which may moved, NULL if failed and \p map kept. */
+void *simpl_registry_remap_huge(void *owner, void *map, size_t old_size, size_t *size);
+
+/** @brief          Unregister and unmap huge block.
+ *  @param[in] map  Mapping of simpl_registry_map_huge.
+ *  @param[in] size Bytes of mapping. */
+void simpl_registry_unmap_huge(void *map, size_t size);
+
+#endif//_SIMPL_HUGE_H
@@ -0,0 +1,330 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-numa.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "simpl.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+typedef CRITICAL_SECTION simpl_numa_lock;
+#define numa_lock_init(lock)    (InitializeCriticalSection(lock), 0)
+#define numa_lock_destroy(lock) DeleteCriticalSection(lock)
+#define numa_lock(lock)         EnterCriticalSection(lock)
+#define numa_unlock(lock)       LeaveCriticalSection(lock)
+#else
+#include <pthread.h>
+typedef pthread_mutex_t simpl_numa_lock;
+#define numa_lock_init(lock)    pthread_mutex_init(lock, NULL)
+#define numa_lock_destroy(lock) pthread_mutex_destroy(lock)
+#define numa_lock(lock)         pthread_mutex_lock(lock)
+#define numa_unlock(lock)       pthread_mutex_unlock(lock)
+#endif//_WIN32
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define numa_mapped
+/** mbind policy, memory only from the node */
+#define numa_mpol_bind (2)
+#endif//__linux__
+
+#ifndef SIMPL_NUMA_MAX_NODES
+/** max nodes of NUMA arena */
+#define SIMPL_NUMA_MAX_NODES (64)
+#endif//SIMPL_NUMA_MAX_NODES
+
+/** pool of one node, memory bound before initialized */
+struct simpl_numa_node {
+	simpl_numa_lock lock;
+	void *buffer;
+	size_t buffer_size;
+	void *pool;
+	/** frees from threads of other nodes */
+	size_t remote_frees;
+};
+
+struct simpl_numa {
+	uint32_t nodes;
+	/** nodes whose buffer mbind succeeded */
+	uint32_t bound;
+	/** node of each CPU for sched_getcpu, NULL if single node or unknown */
+	uint8_t *cpu_node;
+	uint32_t cpus;
+	struct simpl_numa_node node[1];
+};
+
+#ifdef numa_mapped
+/** @brief             Read range list of sysfs, such as "0-3,8,10-11".
+ *  @param[in] path     Sysfs file.
+ *  @param[in] callback Called for each range [first, last].
+ *  @param[in] arg      Argument of callback.
+ *  @return             0 if file not found. */
+static int numa_read_list(const char *path, void (*callback)(void *, unsigned int, unsigned int), void *arg)
+{
+	FILE *file = fopen(path, "r");
+	unsigned int first, last;
+	int c = ',';
+
+	if (!file)
+		return 0;
+	while (c == ',' && fscanf(file, "%u", &first) == 1) {
+		last = first;
+		if ((c = fgetc(file)) == '-' && fscanf(file, "%u", &last) == 1)
+			c = fgetc(file);
+		callback(arg, first, last);
+	}
+	fclose(file);
+	return 1;
+}
+
+static void numa_count_range(void *arg, unsigned int first, unsigned int last)
+{
+	(void)first;
+	if (last + 1 > *(unsigned int *)arg)
+		*(unsigned int *)arg = last + 1;
+}
+
+/** node being read by numa_map_cpus */
+struct numa_cpu_range {
+	struct simpl_numa *numa;
+	uint8_t node;
+};
+
+static void numa_map_range(void *arg, unsigned int first, unsigned int last)
+{
+	struct numa_cpu_range *range = (struct numa_cpu_range *)arg;
+
+	for (; first <= last && first < range->numa->cpus; first++)
+		range->numa->cpu_node[first] = range->node;
+}
+
+/** @brief          Build node table of CPUs from sysfs, kept NULL if unknown.
+ *  @param[in] numa NUMA arena. */
+static void numa_map_cpus(struct simpl_numa *numa)
+{
+	struct numa_cpu_range range;
+	char path[64];
+	long cpus = sysconf(_SC_NPROCESSORS_CONF);
+
+	if (numa->nodes < 2 || cpus < 1 || !(numa->cpu_node = (uint8_t *)calloc((size_t)cpus, 1)))
+		return;
+	numa->cpus = (uint32_t)cpus;
+	range.numa = numa;
+	for (range.node = 0; range.node < numa->nodes; range.node++) {
+		sprintf(path, "/sys/devices/system/node/node%u/cpulist", (unsigned int)range.node);
+		numa_read_list(path, numa_map_range, &range);
+	}
+}
+#endif//numa_mapped
+
+/** @brief  Count NUMA nodes from sysfs, highest online node plus one.
+ *  @return Nodes, 1 if not NUMA or unknown. */
+static uint32_t numa_node_count(void)
+{
+#ifdef numa_mapped
+	unsigned int nodes = 1;
+
+	numa_read_list("/sys/devices/system/node/online", numa_count_range, &nodes);
+	return nodes > SIMPL_NUMA_MAX_NODES? SIMPL_NUMA_MAX_NODES: nodes;
+#else
+	return 1;
+#endif//numa_mapped
+}
+
+/** @brief           Node of calling thread.
+ *  @param[in] numa  NUMA arena.
+ *  @return          Node index, 0 if unknown.
+ *  @note            sched_getcpu is read from vDSO, no system call per operation. */
+static uint32_t numa_current_node(struct simpl_numa *numa)
+{
+#ifdef numa_mapped
+	int cpu;
+
+	if (numa->cpu_node && (cpu = sched_getcpu()) >= 0 && (uint32_t)cpu < numa->cpus)
+		return numa->cpu_node[cpu];
+#else
+	(void)numa;
+#endif//numa_mapped
+	return 0;
+}
+
+/** @brief           Allocate buffer of node.
+ *  @param[in] node  Node index.
+ *  @param[in] size  Buffer size.
+ *  @param[out] bound Non-zero if mbind succeeded.
+ *  @return          Buffer, NULL if out of memory.
+ *  @note            Binding failure is reported only, memory of other node is still usable. */
+static void *numa_map_buffer(uint32_t node, size_t size, int *bound)
+{
+#ifdef numa_mapped
+	unsigned long mask[SIMPL_NUMA_MAX_NODES / (8 * sizeof(unsigned long)) + 1] = {0};
+	void *buffer = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+	*bound = 0;
+	if (buffer == MAP_FAILED)
+		return NULL;
+#ifdef SYS_mbind
+	mask[node / (8 * sizeof(unsigned long))] = 1UL << node % (8 * sizeof(unsigned long));
+	*bound = !syscall(SYS_mbind, buffer, size, numa_mpol_bind, mask, sizeof(mask) * 8, 0);
+#endif//SYS_mbind
+	return buffer;
+#else
+	(void)node;
+	*bound = 0;
+	return malloc(size);
+#endif//numa_mapped
+}
+
+static void numa_unmap_buffer(void *buffer, size_t size)
+{
+#ifdef numa_mapped
+	munmap(buffer, size);
+#else
+	(void)size;
+	free(buffer);
+#endif//numa_mapped
+}
+
+void *simpl_numa_create(size_t node_size, unsigned int flags)
+{
+	struct simpl_numa *numa;
+	struct simpl_numa_node *node;
+	uint32_t i, nodes = numa_node_count();
+	int bound;
+
+	if (!node_size || node_size > UINT32_MAX)
+		return NULL;
+	numa = (struct simpl_numa *)calloc(1, offsetof(struct simpl_numa, node) + nodes * sizeof(struct simpl_numa_node));
+	if (!numa)
+		return NULL;
+	for (i = 0; i < nodes; i++) {
+		node = &numa->node[i];
+		if (numa_lock_init(&node->lock))
+			break;
+		numa->nodes = i + 1;
+		node->buffer_size = node_size;
+		if (!(node->buffer = numa_map_buffer(i, node_size, &bound)) ||
+			!(node->pool = simpl_init_ex(node->buffer, node_size, flags)))
+			break;
+		numa->bound += (uint32_t)bound;
+	}
+	if (i < nodes) {
+		simpl_numa_destroy(numa);
+		return NULL;
+	}
+#ifdef numa_mapped
+	numa_map_cpus(numa);
+#endif//numa_mapped
+	return numa;
+}
+
+void simpl_numa_destroy(void *numa_handle)
+{
+	struct simpl_numa *numa = (struct simpl_numa *)numa_handle;
+	uint32_t i;
+
+	if (!numa)
+		return;
+	for (i = 0; i < numa->nodes; i++) {
+		if (numa->node[i].buffer)
+			numa_unmap_buffer(numa->node[i].buffer, numa->node[i].buffer_size);
+		numa_lock_destroy(&numa->node[i].lock);
+	}
+	free(numa->cpu_node);
+	free(numa);
+}
+
+void *simpl_numa_malloc(void *numa_handle, size_t alloc_size)
+{
+	struct simpl_numa *numa = (struct simpl_numa *)numa_handle;
+	struct simpl_numa_node *node;
+	uint32_t i, current;
+	void *simple = NULL;
+
+	if (!numa)
+		return NULL;
+	current = numa_current_node(numa);
+	for (i = 0; i < numa->nodes && !simple; i++) { /* local first, then spill to other nodes */
+		node = &numa->node[(current + i) % numa->nodes];
+		numa_lock(&node->lock);
+		simple = simpl_malloc(node->pool, alloc_size);
+		numa_unlock(&node->lock);
+	}
+	return simple;
+}
+
+void simpl_numa_free(void *numa_handle, void *simple)
+{
+	struct simpl_numa *numa = (struct simpl_numa *)numa_handle;
+	struct simpl_numa_node *node;
+	uint32_t i;
+
+	if (!numa || !simple)
+		return;
+	for (i = 0; i < numa->nodes; i++) { /* owner by address range */
+		node = &numa->node[i];
+		if ((uint8_t *)simple >= (uint8_t *)node->buffer &&
+			(uint8_t *)simple < (uint8_t *)node->buffer + node->buffer_size)
+			break;
+	}
+	if (i == numa->nodes)
+		return;
+	numa_lock(&node->lock);
+	if (i != numa_current_node(numa))
+		node->remote_frees++;
+	simpl_free(node->pool, simple);
+	numa_unlock(&node->lock);
+}
+
+void simpl_numa_get_stats(void *numa_handle, struct simpl_numa_stats *stats)
+{
+	struct simpl_numa *numa = (struct simpl_numa *)numa_handle;
+	struct simpl_numa_node *node;
+	struct simpl_stats pool_stats;
+	uint32_t i;
+
+	if (!numa || !stats)
+		return;
+	memset(stats, 0, sizeof(struct simpl_numa_stats));
+	stats->nodes = numa->nodes;
+	stats->bound = numa->nodes > 1 && numa->bound == numa->nodes; /* every node bound by mbind */
+	for (i = 0; i < numa->nodes; i++) {
+		node = &numa->node[i];
+		numa_lock(&node->lock);
+		simpl_get_stats(node->pool, &pool_stats);
+		stats->remote_frees += node->remote_frees;
+		numa_unlock(&node->lock);
+		stats->available += pool_stats.available;
+	}
+}
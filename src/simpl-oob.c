@@ -0,0 +1,310 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-oob.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "simpl.h"
+
+/** end of free list */
+#define oob_none UINT32_MAX
+/** size classes of runs, floor(log2(granules)) */
+#define oob_classes (32)
+/** free runs scanned in the class of request when no larger class is free */
+#define oob_scan (16)
+
+/** granule pool, side table in front of payloads
+ *  size of run is kept at its first and last granule, links of free run
+ *  at its first granule, payload of granule is never touched. */
+struct simpl_oob {
+	/** payload of granule 0, aligned to granule */
+	uint8_t *base;
+	uint32_t granules;
+	uint32_t shift;
+	/** free granules */
+	uint32_t available;
+	uint32_t class_bitmap;
+	uint32_t heads[oob_classes];
+	uint32_t *size;
+	uint32_t *next;
+	uint32_t *prev;
+	/** bit per granule, set at first granule of every run */
+	uint32_t *boundary;
+	/** bit per granule, set at first granule of used run */
+	uint32_t *used;
+};
+
+static inline int oob_fls(uint32_t dw) {
+#if defined(__GNUC__)
+	return dw? 32 - __builtin_clz(dw): 0;
+#else
+	int bit = 0;
+
+	while (dw) {
+		dw >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+static inline int oob_ffs(uint32_t dw) {
+	return oob_fls(dw & (~dw + 1));
+}
+
+static inline int test_bit(const uint32_t *bitmap, uint32_t g) {
+	return (bitmap[g / 32] >> (g % 32)) & 1;
+}
+
+static inline void set_bit(uint32_t *bitmap, uint32_t g) {
+	bitmap[g / 32] |= 1U << (g % 32);
+}
+
+static inline void clear_bit(uint32_t *bitmap, uint32_t g) {
+	bitmap[g / 32] &= ~(1U << (g % 32));
+}
+
+static inline uint32_t run_class(uint32_t n) {
+	return (uint32_t)oob_fls(n) - 1;
+}
+
+/** @brief          Describe run of n granules from g in side table.
+ *  @param[in] oob  Granule pool.
+ *  @param[in] g    First granule.
+ *  @param[in] n    Granules of run. */
+static inline void set_run(struct simpl_oob *oob, uint32_t g, uint32_t n)
+{
+	oob->size[g] = oob->size[g + n - 1] = n;
+	set_bit(oob->boundary, g);
+}
+
+static void push_run(struct simpl_oob *oob, uint32_t g, uint32_t n)
+{
+	uint32_t c = run_class(n);
+
+	set_run(oob, g, n);
+	clear_bit(oob->used, g);
+	oob->prev[g] = oob_none;
+	oob->next[g] = oob->heads[c];
+	if (oob->heads[c] != oob_none)
+		oob->prev[oob->heads[c]] = g;
+	oob->heads[c] = g;
+	oob->class_bitmap |= 1U << c;
+	oob->available += n;
+}
+
+static void pop_run(struct simpl_oob *oob, uint32_t g)
+{
+	uint32_t c = run_class(oob->size[g]);
+
+	if (oob->prev[g] != oob_none)
+		oob->next[oob->prev[g]] = oob->next[g];
+	else if ((oob->heads[c] = oob->next[g]) == oob_none)
+		oob->class_bitmap &= ~(1U << c);
+	if (oob->next[g] != oob_none)
+		oob->prev[oob->next[g]] = oob->prev[g];
+	oob->available -= oob->size[g];
+}
+
+/** @brief          Good-fit search, O(1) unless only the class of request has free runs.
+ *  @param[in] oob  Granule pool.
+ *  @param[in] n    Granules required.
+ *  @return         First granule of free run not less than n, oob_none if not found. */
+static uint32_t find_run(struct simpl_oob *oob, uint32_t n)
+{
+	uint32_t c = run_class(n), g, i;
+	/** every run of the class fits if n is power of 2 */
+	uint32_t bitmap = oob->class_bitmap & (~0U << c << (n & (n - 1)? 1: 0));
+
+	if (bitmap)
+		return oob->heads[oob_ffs(bitmap) - 1];
+	for (g = oob->heads[c], i = 0; g != oob_none && i < oob_scan; g = oob->next[g], i++) {
+		if (oob->size[g] >= n)
+			return g;
+	}
+	return oob_none;
+}
+
+/** @brief           Use n granules from free run g, head and tail remainders stay free.
+ *  @param[in] oob   Granule pool.
+ *  @param[in] g     First granule of free run.
+ *  @param[in] head  Granules left free before the used run.
+ *  @param[in] n     Granules of used run.
+ *  @return          Payload of used run. */
+static void *use_run(struct simpl_oob *oob, uint32_t g, uint32_t head, uint32_t n)
+{
+	uint32_t size = oob->size[g];
+
+	pop_run(oob, g);
+	if (head) {
+		push_run(oob, g, head);
+		g += head;
+		size -= head;
+	}
+	if (size > n)
+		push_run(oob, g + n, size - n);
+	set_run(oob, g, n);
+	set_bit(oob->used, g);
+	return oob->base + ((size_t)g << oob->shift);
+}
+
+/** @brief               Granules of request.
+ *  @param[in] oob        Granule pool.
+ *  @param[in] alloc_size Bytes.
+ *  @return               Granules, 0 if too large. */
+static uint32_t granules_of(struct simpl_oob *oob, size_t alloc_size)
+{
+	size_t n = alloc_size? ((alloc_size - 1) >> oob->shift) + 1: 1;
+
+	return n > oob->granules? 0: (uint32_t)n;
+}
+
+void *simpl_oob_init(void *buffer, size_t size, size_t granule)
+{
+	struct simpl_oob *oob;
+	uint8_t *table, *end = (uint8_t *)buffer + size;
+	uintptr_t base;
+	size_t granules, words;
+
+	if (!buffer || granule < sizeof(void *) || (granule & (granule - 1)) ||
+		(uintptr_t)buffer & (sizeof(void *) - 1) || size < sizeof(struct simpl_oob) + 2 * granule)
+		return NULL;
+	granules = (size - sizeof(struct simpl_oob)) / (granule + 3 * sizeof(uint32_t) + 1);
+	if (granules >= oob_none)
+		granules = oob_none - 1;
+	for (; granules; granules--) { /* side table then payloads aligned to granule */
+		words = (granules + 31) / 32;
+		table = (uint8_t *)buffer + sizeof(struct simpl_oob);
+		base = ((uintptr_t)table + (3 * granules + 2 * words) * sizeof(uint32_t) + granule - 1) & ~(uintptr_t)(granule - 1);
+		if (base + granules * granule <= (uintptr_t)end)
+			break;
+	}
+	if (!granules)
+		return NULL;
+
+	oob = (struct simpl_oob *)buffer;
+	memset(oob, 0, sizeof(struct simpl_oob));
+	oob->base = (uint8_t *)base;
+	oob->granules = (uint32_t)granules;
+	while (((size_t)1 << oob->shift) < granule)
+		oob->shift++;
+	oob->size = (uint32_t *)table;
+	oob->next = oob->size + granules;
+	oob->prev = oob->next + granules;
+	oob->boundary = oob->prev + granules;
+	oob->used = oob->boundary + words;
+	memset(oob->boundary, 0, 2 * words * sizeof(uint32_t));
+	memset(oob->heads, 0xff, sizeof(oob->heads));
+	push_run(oob, 0, (uint32_t)granules);
+	return oob;
+}
+
+void *simpl_oob_malloc(void *simp, size_t alloc_size)
+{
+	struct simpl_oob *oob = (struct simpl_oob *)simp;
+	uint32_t n, g;
+
+	if (!oob || !(n = granules_of(oob, alloc_size)) || (g = find_run(oob, n)) == oob_none)
+		return NULL;
+	return use_run(oob, g, 0, n);
+}
+
+void *simpl_oob_memalign(void *simp, size_t alignment, size_t alloc_size)
+{
+	struct simpl_oob *oob = (struct simpl_oob *)simp;
+	uintptr_t payload, mask = alignment - 1;
+	uint32_t n, g, head, slack;
+
+	if (!oob || (alignment & mask))
+		return NULL;
+	if (alignment >> oob->shift <= 1)
+		return simpl_oob_malloc(simp, alloc_size);
+	slack = (uint32_t)((alignment >> oob->shift) - 1);
+	if (!(n = granules_of(oob, alloc_size)) || n > oob->granules - slack)
+		return NULL;
+	if ((g = find_run(oob, n + slack)) == oob_none)
+		return NULL;
+	payload = (uintptr_t)oob->base + ((uintptr_t)g << oob->shift);
+	head = (uint32_t)((((payload + mask) & ~mask) - payload) >> oob->shift);
+	return use_run(oob, g, head, n);
+}
+
+void simpl_oob_free(void *simp, void *simple)
+{
+	struct simpl_oob *oob = (struct simpl_oob *)simp;
+	size_t offset;
+	uint32_t g, n, neighbor;
+
+	if (!oob || !simple || (uint8_t *)simple < oob->base)
+		return;
+	offset = (size_t)((uint8_t *)simple - oob->base);
+	g = (uint32_t)(offset >> oob->shift);
+	if (offset & (((size_t)1 << oob->shift) - 1) || offset >> oob->shift >= oob->granules ||
+		!test_bit(oob->boundary, g) || !test_bit(oob->used, g))
+		return; /* not a used run, or freed twice */
+	n = oob->size[g];
+	clear_bit(oob->used, g);
+	neighbor = g + n;
+	if (neighbor < oob->granules && !test_bit(oob->used, neighbor)) {
+		pop_run(oob, neighbor);
+		clear_bit(oob->boundary, neighbor);
+		n += oob->size[neighbor];
+	}
+	if (g && !test_bit(oob->used, (neighbor = g - oob->size[g - 1]))) {
+		pop_run(oob, neighbor);
+		clear_bit(oob->boundary, g);
+		n += oob->size[neighbor];
+		g = neighbor;
+	}
+	push_run(oob, g, n);
+}
+
+size_t simpl_oob_usable_size(void *simp, const void *simple)
+{
+	struct simpl_oob *oob = (struct simpl_oob *)simp;
+	size_t offset;
+
+	if (!oob || !simple || (const uint8_t *)simple < oob->base)
+		return 0;
+	offset = (size_t)((const uint8_t *)simple - oob->base);
+	if (offset & (((size_t)1 << oob->shift) - 1) || offset >> oob->shift >= oob->granules ||
+		!test_bit(oob->used, (uint32_t)(offset >> oob->shift)))
+		return 0;
+	return (size_t)oob->size[offset >> oob->shift] << oob->shift;
+}
+
+void simpl_oob_get_stats(void *simp, struct simpl_stats *stats)
+{
+	struct simpl_oob *oob = (struct simpl_oob *)simp;
+
+	if (!stats)
+		return;
+	memset(stats, 0, sizeof(struct simpl_stats));
+	if (!oob)
+		return;
+	stats->available = (size_t)oob->available << oob->shift;
+	if (oob->class_bitmap)
+		stats->largest_free = (size_t)oob->size[oob->heads[oob_fls(oob->class_bitmap) - 1]] << oob->shift;
+}
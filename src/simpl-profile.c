@@ -0,0 +1,256 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-profile.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include "simpl.h"
+#include "simpl-profile.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#define write_fd(fd, buf, len) _write(fd, buf, (unsigned int)(len))
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#define write_fd(fd, buf, len) write(fd, buf, len)
+#endif//_WIN32
+
+#if defined(__GLIBC__)
+#include <execinfo.h>
+#endif//__GLIBC__
+
+/** frames of simpl_profile_record and SIMPL API */
+#define profile_skip_frames (2)
+
+static inline uint32_t profile_random(struct simpl_profile *profile) {
+	uint32_t x = profile->seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return profile->seed = x;
+}
+
+/** @brief             Next exponentially distributed sampling interval.
+ *  @param[in] profile Profile.
+ *  @return            Bytes until next sample, mean is period.
+ *  @note              -ln(u) = (32 - log2(r)) * ln2, log2 is linear over mantissa in 16.16 fixed point. */
+static uint64_t profile_interval(struct simpl_profile *profile)
+{
+	uint32_t r = profile_random(profile) | 1U;
+	uint32_t e = 31, frac;
+
+	while (!(r >> e))
+		e--;
+	frac = e >= 16? (r >> (e - 16)) & 0xffffU: (r << (16 - e)) & 0xffffU;
+	return (uint64_t)profile->period * (((32U << 16) - ((e << 16) | frac)) * (uint64_t)45426U >> 16) >> 16;
+}
+
+static inline uint32_t profile_hash(struct simpl_profile *profile, void *ptr) {
+	return (uint32_t)((uintptr_t)ptr >> 3) * 0x9e3779b1U & profile->mask;
+}
+
+/** capture call stack into frames, must expand in simpl_profile_record */
+#if defined(__GLIBC__)
+#define profile_backtrace(frames, max) backtrace(frames, max)
+#elif defined(_WIN32)
+#define profile_backtrace(frames, max) CaptureStackBackTrace(0, max, frames, NULL)
+#else
+#define profile_backtrace(frames, max) ((void)(frames), 0)
+#endif
+
+struct simpl_profile *simpl_profile_create(void *simp, size_t period, size_t max_samples)
+{
+	struct simpl_profile *profile;
+	size_t slots = 2;
+
+	if (period > UINT32_MAX || max_samples > UINT32_MAX / 2)
+		return NULL;
+	while (slots < max_samples * 2)
+		slots <<= 1;
+	profile = (struct simpl_profile *)simpl_malloc(simp,
+		offsetof(struct simpl_profile, samples) + slots * sizeof(struct simpl_profile_sample));
+	if (!profile)
+		return NULL;
+	memset(profile, 0, offsetof(struct simpl_profile, samples) + slots * sizeof(struct simpl_profile_sample));
+	profile->period = (uint32_t)period;
+	profile->seed = (uint32_t)((uintptr_t)profile >> 4) | 1U;
+	profile->mask = (uint32_t)slots - 1;
+	profile->max_samples = (uint32_t)max_samples;
+	profile->countdown = (int64_t)profile_interval(profile);
+	return profile;
+}
+
+void simpl_profile_record(struct simpl_profile *profile, void *ptr, uint32_t size)
+{
+	struct simpl_profile_sample *sample;
+	void *frames[SIMPL_PROFILE_DEPTH + profile_skip_frames];
+	uint32_t i;
+	int depth;
+
+	profile->countdown = (int64_t)profile_interval(profile);
+	if (profile->count >= profile->max_samples)
+		return;
+	for (i = profile_hash(profile, ptr); profile->samples[i].ptr; i = (i + 1) & profile->mask)
+		if (profile->samples[i].ptr == ptr)
+			break;
+	sample = &profile->samples[i];
+	if (!sample->ptr)
+		profile->count++;
+	sample->ptr = ptr;
+	sample->size = size;
+	depth = profile_backtrace(frames, SIMPL_PROFILE_DEPTH + profile_skip_frames) - profile_skip_frames;
+	sample->depth = depth > 0? (uint32_t)depth: 0;
+	memcpy(sample->stack, frames + profile_skip_frames, sample->depth * sizeof(void *));
+}
+
+/** @brief             Remove sample by backward shift, keep probe sequences unbroken.
+ *  @param[in] profile Profile.
+ *  @param[in] i       Slot of sample. */
+static void profile_remove(struct simpl_profile *profile, uint32_t i)
+{
+	uint32_t j = i, k;
+
+	for (;;) {
+		j = (j + 1) & profile->mask;
+		if (!profile->samples[j].ptr)
+			break;
+		k = profile_hash(profile, profile->samples[j].ptr);
+		if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+			memcpy(&profile->samples[i], &profile->samples[j], sizeof(struct simpl_profile_sample));
+			i = j;
+		}
+	}
+	profile->samples[i].ptr = NULL;
+	profile->count--;
+}
+
+void simpl_profile_erase(struct simpl_profile *profile, void *ptr)
+{
+	uint32_t i;
+
+	if (!profile->count)
+		return;
+	for (i = profile_hash(profile, ptr); profile->samples[i].ptr; i = (i + 1) & profile->mask) {
+		if (profile->samples[i].ptr == ptr) {
+			profile_remove(profile, i);
+			return;
+		}
+	}
+}
+
+void simpl_profile_erase_range(struct simpl_profile *profile, void *begin, void *end)
+{
+	uint8_t *p;
+	uint32_t i;
+
+	for (i = 0; i <= profile->mask && profile->count; i++) {
+		while ((p = (uint8_t *)profile->samples[i].ptr) && p >= (uint8_t *)begin && p < (uint8_t *)end)
+			profile_remove(profile, i);
+	}
+}
+
+static int profile_write_all(int fd, const char *buf, size_t len)
+{
+	long n;
+
+	while (len) {
+		if ((n = (long)write_fd(fd, buf, len)) < 0) {
+			if (errno == EINTR)
+				continue;
+			return -errno;
+		}
+		buf += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+/** @brief    Copy memory mappings for symbolization, nothing if unsupported.
+ *  @param fd File descriptor.
+ *  @return   0 if succeed, negative errno if failed. */
+static int profile_write_maps(int fd)
+{
+#if defined(__linux__)
+	char buf[4096];
+	long n;
+	int maps, ret = 0;
+
+	if ((maps = open("/proc/self/maps", O_RDONLY)) < 0)
+		return 0;
+	while ((n = (long)read(maps, buf, sizeof(buf))) != 0) {
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		if ((ret = profile_write_all(fd, buf, (size_t)n)))
+			break;
+	}
+	close(maps);
+	return ret;
+#else
+	(void)fd;
+	return 0;
+#endif//__linux__
+}
+
+int simpl_profile_write(struct simpl_profile *profile, int fd)
+{
+	struct simpl_profile_sample *sample;
+	char line[64 + SIMPL_PROFILE_DEPTH * 20];
+	uint64_t bytes = 0;
+	uint32_t i, d;
+	int len, ret;
+
+	for (i = 0; i <= profile->mask; i++)
+		bytes += profile->samples[i].ptr? profile->samples[i].size: 0;
+	len = snprintf(line, sizeof(line), "heap profile: %6u: %8" PRIu64 " [%6u: %8" PRIu64 "] @ heap_v2/%u\n",
+		profile->count, bytes, profile->count, bytes, profile->period);
+	if ((ret = profile_write_all(fd, line, (size_t)len)))
+		return ret;
+	for (i = 0; i <= profile->mask; i++) {
+		sample = &profile->samples[i];
+		if (!sample->ptr)
+			continue;
+		len = snprintf(line, sizeof(line), "%6u: %8u [%6u: %8u] @", 1U, sample->size, 1U, sample->size);
+		for (d = 0; d < sample->depth; d++)
+			len += snprintf(line + len, sizeof(line) - len, " 0x%" PRIxPTR, (uintptr_t)sample->stack[d]);
+		line[len++] = '\n';
+		if ((ret = profile_write_all(fd, line, (size_t)len)))
+			return ret;
+	}
+	if ((ret = profile_write_all(fd, "\nMAPPED_LIBRARIES:\n", 19)))
+		return ret;
+	return profile_write_maps(fd);
+}
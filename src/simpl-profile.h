@@ -0,0 +1,95 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-profile.h
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_PROFILE_H
+#define _SIMPL_PROFILE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SIMPL_PROFILE_DEPTH
+/** max stack frames of sample */
+#define SIMPL_PROFILE_DEPTH (32)
+#endif//SIMPL_PROFILE_DEPTH
+
+/** sampled SIMPL element, ptr NULL when slot empty */
+struct simpl_profile_sample {
+	void *ptr;
+	uint32_t size;
+	uint32_t depth;
+	void *stack[SIMPL_PROFILE_DEPTH];
+};
+
+/** <pre>
+ *  Sampling heap profile, allocated from the profiled SIMP.
+ *  Samples are kept in an open addressing table keyed by payload,
+ *  about one SIMPL element per period bytes is sampled. </pre> */
+struct simpl_profile {
+	/** bytes until next sample */
+	int64_t countdown;
+	uint32_t period;
+	uint32_t seed;
+	/** table slots - 1 */
+	uint32_t mask;
+	uint32_t count;
+	uint32_t max_samples;
+	struct simpl_profile_sample samples[1];
+};
+
+/** @brief              Allocate and initialize profile from SIMP.
+ *  @param[in] simp      SIMP handle.
+ *  @param[in] period    Average sampling period in bytes.
+ *  @param[in] max_samples Max live samples.
+ *  @return             Profile, NULL if out of memory. */
+struct simpl_profile *simpl_profile_create(void *simp, size_t period, size_t max_samples);
+
+/** @brief             Record SIMPL element and reset countdown.
+ *  @param[in] profile Profile.
+ *  @param[in] ptr     SIMPL element.
+ *  @param[in] size    Chunk size of element. */
+void simpl_profile_record(struct simpl_profile *profile, void *ptr, uint32_t size);
+
+/** @brief             Drop sample of SIMPL element if exist.
+ *  @param[in] profile Profile.
+ *  @param[in] ptr     SIMPL element. */
+void simpl_profile_erase(struct simpl_profile *profile, void *ptr);
+
+/** @brief             Drop samples inside address range.
+ *  @param[in] profile Profile.
+ *  @param[in] begin   Range begin.
+ *  @param[in] end     Range end. */
+void simpl_profile_erase_range(struct simpl_profile *profile, void *begin, void *end);
+
+/** @brief             Write pprof legacy heap profile.
+ *  @param[in] profile Profile.
+ *  @param[in] fd      File descriptor.
+ *  @return            0 if succeed, negative errno if failed. */
+int simpl_profile_write(struct simpl_profile *profile, int fd);
+
+static inline int simpl_profile_tick(struct simpl_profile *profile, uint32_t size) {
+	return (profile->countdown -= size) <= 0;
+}
+
+#endif//_SIMPL_PROFILE_H
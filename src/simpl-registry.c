@@ -0,0 +1,268 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-registry.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "simpl.h"
+#include "simpl-huge.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+static SRWLOCK registry_lock = SRWLOCK_INIT;
+#define lock_registry()   AcquireSRWLockExclusive(&registry_lock)
+#define unlock_registry() ReleaseSRWLockExclusive(&registry_lock)
+#else
+#include <pthread.h>
+#include <sys/mman.h>
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+#define lock_registry()   pthread_mutex_lock(&registry_lock)
+#define unlock_registry() pthread_mutex_unlock(&registry_lock)
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif//_WIN32
+
+#ifndef SIMPL_REGISTRY_SHIFT
+/** log2 of super-region alignment, a super-region belongs to one SIMP */
+#define SIMPL_REGISTRY_SHIFT (20)
+#endif//SIMPL_REGISTRY_SHIFT
+
+/** <pre>
+ *  address:  | top index | leaf index | offset in super-region |
+ *            |           |            |<- SIMPL_REGISTRY_SHIFT ->|
+ *  top table is static, leaves are allocated on first pool of their range,
+ *  never released so lookups don't race with destroy of other pools. </pre> */
+enum {
+	registry_address_bits = (UINTPTR_MAX > 0xffffffffU)? 48: 32,
+	registry_index_bits   = registry_address_bits - SIMPL_REGISTRY_SHIFT,
+	registry_leaf_bits    = registry_index_bits / 2,
+	registry_top_size     = 1 << (registry_index_bits - registry_leaf_bits),
+	registry_leaf_size    = 1 << registry_leaf_bits,
+};
+
+#define registry_granule ((size_t)1 << SIMPL_REGISTRY_SHIFT)
+
+struct registry_leaf {
+	void *pool[registry_leaf_size];
+};
+
+/** header of super-regions, SIMP follows */
+struct registry_region {
+	size_t size;
+	void *pool;
+};
+
+static struct registry_leaf *registry_top[registry_top_size];
+
+static void *map_region(size_t size)
+{
+#if defined(_WIN32)
+	return _aligned_malloc(size, registry_granule);
+#else
+	uint8_t *map, *region;
+
+	map = (uint8_t *)mmap(NULL, size + registry_granule, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+	region = (uint8_t *)(((uintptr_t)map + registry_granule - 1) & ~(uintptr_t)(registry_granule - 1));
+	if (region != map) /* trim to alignment */
+		munmap(map, (size_t)(region - map));
+	munmap(region + size, registry_granule - (size_t)(region - map));
+	return region;
+#endif//_WIN32
+}
+
+static void unmap_region(void *region, size_t size)
+{
+#if defined(_WIN32)
+	(void)size;
+	_aligned_free(region);
+#else
+	munmap(region, size);
+#endif//_WIN32
+}
+
+/** @brief            Set owner of super-regions, under registry lock.
+ *  @param[in] region Super-region, aligned.
+ *  @param[in] size   Bytes, multiple of super-region.
+ *  @param[in] pool   Owner, NULL to unregister.
+ *  @return           0 if succeed, -ENOMEM if leaf can't be allocated. */
+static int register_region(void *region, size_t size, void *pool)
+{
+	uintptr_t index = (uintptr_t)region >> SIMPL_REGISTRY_SHIFT, last = index + (size >> SIMPL_REGISTRY_SHIFT);
+	struct registry_leaf **leaf;
+
+	for (; index < last; index++) {
+		leaf = &registry_top[index >> registry_leaf_bits];
+		if (!*leaf && !pool)
+			continue;
+		if (!*leaf && !(*leaf = (struct registry_leaf *)calloc(1, sizeof(struct registry_leaf))))
+			return -ENOMEM;
+		(*leaf)->pool[index & (registry_leaf_size - 1)] = pool;
+	}
+	return 0;
+}
+
+void *simpl_pool_create(size_t pool_size, unsigned int flags)
+{
+	struct registry_region *region;
+	size_t size;
+
+	if (!pool_size || pool_size > UINT32_MAX)
+		return NULL;
+	size = (pool_size + sizeof(struct registry_region) + registry_granule - 1) & ~(registry_granule - 1);
+	if (!(region = (struct registry_region *)map_region(size)))
+		return NULL;
+	if (((uintptr_t)region + size - 1) >> (registry_address_bits - 1) >> 1) { /* out of radix table */
+		unmap_region(region, size);
+		return NULL;
+	}
+	region->size = size;
+	region->pool = simpl_init_ex(region + 1, pool_size, flags);
+	lock_registry();
+	if (!region->pool || register_region(region, size, region->pool)) {
+		register_region(region, size, NULL);
+		unlock_registry();
+		unmap_region(region, size);
+		return NULL;
+	}
+	unlock_registry();
+	return region->pool;
+}
+
+void simpl_pool_destroy(void *simp)
+{
+	struct registry_region *region;
+
+	if (!simp || simpl_pool_of(simp) != simp)
+		return;
+	region = (struct registry_region *)((uintptr_t)simp & ~(uintptr_t)(registry_granule - 1));
+	simpl_reset(simp); /* huge blocks of SIMP and its children are unmapped */
+	lock_registry();
+	register_region(region, region->size, NULL);
+	unlock_registry();
+	unmap_region(region, region->size);
+}
+
+void *simpl_registry_map_huge(void *owner, size_t *size)
+{
+#if defined(_WIN32)
+	(void)owner;
+	(void)size;
+	return NULL; /* huge blocks are not mapped, as simpl_huge_map */
+#else
+	void *map;
+	size_t map_size = (*size + registry_granule - 1) & ~(registry_granule - 1);
+
+	if (map_size < *size || !(map = map_region(map_size)))
+		return NULL;
+	if (((uintptr_t)map + map_size - 1) >> (registry_address_bits - 1) >> 1) {
+		unmap_region(map, map_size);
+		return NULL;
+	}
+	lock_registry();
+	if (register_region(map, map_size, owner)) {
+		register_region(map, map_size, NULL);
+		unlock_registry();
+		unmap_region(map, map_size);
+		return NULL;
+	}
+	unlock_registry();
+	*size = map_size;
+	return map;
+#endif//_WIN32
+}
+
+void *simpl_registry_remap_huge(void *owner, void *map, size_t old_size, size_t *size)
+{
+#if defined(_WIN32)
+	(void)owner;
+	(void)map;
+	(void)old_size;
+	(void)size;
+	return NULL;
+#else
+	void *new_map;
+	size_t map_size = *size;
+
+	if (((map_size + registry_granule - 1) & ~(registry_granule - 1)) == old_size) {
+		*size = old_size;
+		return map;
+	}
+	if (!(new_map = simpl_registry_map_huge(owner, &map_size)))
+		return NULL;
+	lock_registry();
+	register_region(map, old_size, NULL); /* registration of moved pages dropped */
+	unlock_registry();
+#if defined(MREMAP_MAYMOVE) && defined(MREMAP_FIXED)
+	if (mremap(map, old_size, map_size, MREMAP_MAYMOVE | MREMAP_FIXED, new_map) != MAP_FAILED) {
+		*size = map_size; /* old range unmapped by kernel, may be mapped again by others */
+		return new_map;
+	}
+#endif
+	memcpy(new_map, map, old_size < map_size? old_size: map_size);
+	unmap_region(map, old_size);
+	*size = map_size;
+	return new_map;
+#endif//_WIN32
+}
+
+void simpl_registry_unmap_huge(void *map, size_t size)
+{
+	lock_registry();
+	register_region(map, size, NULL);
+	unlock_registry();
+	unmap_region(map, size);
+}
+
+void *simpl_pool_of(const void *ptr)
+{
+	uintptr_t index = (uintptr_t)ptr >> SIMPL_REGISTRY_SHIFT;
+	struct registry_leaf *leaf;
+
+	if (index >> (registry_index_bits - 1) >> 1)
+		return NULL;
+	leaf = registry_top[index >> registry_leaf_bits];
+	return leaf? leaf->pool[index & (registry_leaf_size - 1)]: NULL;
+}
+
+int simpl_free_any(void *simple)
+{
+	void *pool;
+
+	if (!simple)
+		return 0;
+	if (!(pool = simpl_pool_of(simple)))
+		return -ENOENT;
+	simpl_free(simpl_owner_of(pool, simple), simple);
+	return 0;
+}
@@ -0,0 +1,88 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-snapshot.h
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_SNAPSHOT_H
+#define _SIMPL_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/** <pre>
+ *  +-------[SNAPSHOT]--------+
+ *  | Header                  |
+ *  +-------------------------+
+ *  | Freelist Lengths        |  uint32_t x freelists
+ *  +-------------------------+
+ *  | Quick List Lengths      |  uint32_t x quick_lists
+ *  +-------------------------+
+ *  | Chunks                  |  physical order, from first chunk
+ *  +-------------------------+ </pre>
+ *  all fields are host byte order, read on the same architecture. */
+#define SIMPL_SNAPSHOT_MAGIC   "SIMPLSNP"
+#define SIMPL_SNAPSHOT_VERSION (1)
+
+struct simpl_snapshot_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	/** simpl_flags of pool */
+	uint32_t flags;
+	uint32_t bytes_per_ptr;
+	uint32_t chunk_overhead;
+	uint32_t chunk_min_size;
+	/** address of first chunk, for alignment analysis */
+	uint64_t base;
+	/** bytes from first chunk to tail chunk */
+	uint32_t pool_size;
+	uint32_t available;
+	uint32_t deferred;
+	uint32_t fl_bitmap;
+	uint8_t sl_bitmaps[24];
+	uint32_t freelists;
+	uint32_t quick_lists;
+	uint32_t chunks;
+	uint32_t reserved;
+};
+
+#define simpl_snapshot_chunk_free       (0x1U)
+#define simpl_snapshot_chunk_prev_free  (0x2U)
+#define simpl_snapshot_chunk_wilderness (0x4U)
+
+struct simpl_snapshot_chunk {
+	/** offset from first chunk */
+	uint32_t offset;
+	uint32_t size;
+	uint16_t flags;
+	uint16_t tag;
+};
+
+/** @brief         Write all bytes to file descriptor.
+ *  @param[in] fd   File descriptor.
+ *  @param[in] data Data.
+ *  @param[in] size Bytes.
+ *  @return         0 if succeed, negative errno if failed. */
+int simpl_snapshot_write(int fd, const void *data, size_t size);
+
+#endif//_SIMPL_SNAPSHOT_H
@@ -0,0 +1,109 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-trace.h
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#ifndef _SIMPL_TRACE_H
+#define _SIMPL_TRACE_H
+
+#include <stdint.h>
+#include "simpl.h"
+
+#if !defined(SIMPL_NO_USDT) && defined(__GNUC__) && defined(__ELF__) && \
+	(defined(__x86_64__) || defined(__aarch64__))
+/** semaphores of probes in .probes section, counted up by tracer when attached */
+#define simpl_usdt_semaphore(name) simpl_##name##_semaphore
+#define simpl_usdt_declare(name) \
+	extern volatile unsigned short simpl_usdt_semaphore(name) __attribute__((visibility("hidden")))
+#define simpl_usdt_define(name) \
+	volatile unsigned short simpl_usdt_semaphore(name) __attribute__((section(".probes"), visibility("hidden")))
+
+simpl_usdt_declare(malloc);
+simpl_usdt_declare(free);
+simpl_usdt_declare(realloc);
+simpl_usdt_declare(memalign);
+simpl_usdt_declare(split);
+simpl_usdt_declare(merge);
+simpl_usdt_declare(fail);
+
+/** @brief          Emit USDT probe simpl:name, stapsdt note format of <sys/sdt.h>.
+ *  @param[in] name Probe name.
+ *  @note
+ *  1. The probe site is a nop, its address, semaphore and argument locations are
+ *     kept in the non-allocated .note.stapsdt section, patched by tracer when attached.
+ *  2. Arguments are 8 bytes each, located in registers, computed only when the
+ *     semaphore is set, so a detached probe costs a load and a not-taken branch. */
+#define simpl_usdt(name, a1, a2, a3, a4) do { \
+	if (__builtin_expect(simpl_usdt_semaphore(name), 0)) \
+		__asm__ __volatile__ ( \
+		"990: nop\n" \
+		".pushsection .note.stapsdt,\"\",\"note\"\n" \
+		".balign 4\n" \
+		".4byte 992f-991f, 994f-993f, 3\n" \
+		"991: .asciz \"stapsdt\"\n" \
+		"992: .balign 4\n" \
+		"993: .8byte 990b\n" \
+		".8byte _.stapsdt.base\n" \
+		".8byte simpl_" #name "_semaphore\n" \
+		".asciz \"simpl\"\n" \
+		".asciz \"" #name "\"\n" \
+		".asciz \"8@%0 8@%1 8@%2 8@%3\"\n" \
+		"994: .balign 4\n" \
+		".popsection\n" \
+		".ifndef _.stapsdt.base\n" \
+		".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+		".weak _.stapsdt.base\n" \
+		".hidden _.stapsdt.base\n" \
+		"_.stapsdt.base: .space 1\n" \
+		".size _.stapsdt.base, 1\n" \
+		".popsection\n" \
+		".endif\n" \
+		:: "r"((uint64_t)(uintptr_t)(a1)), "r"((uint64_t)(a2)), \
+		"r"((uint64_t)(uintptr_t)(a3)), "r"((uint64_t)(a4))); \
+} while (0)
+#define simpl_usdt_enabled
+#else
+#define simpl_usdt(name, a1, a2, a3, a4) ((void)0)
+#endif
+
+#ifdef SIMPL_TRACE_HOOKS
+extern simpl_trace_hook simpl_trace_hook_fn;
+
+#define simpl_trace_call(event, pool, size, ptr, fi) \
+	(simpl_trace_hook_fn? simpl_trace_hook_fn(pool, event, size, ptr, fi): (void)0)
+#else
+#define simpl_trace_call(event, pool, size, ptr, fi) ((void)0)
+#endif//SIMPL_TRACE_HOOKS
+
+/** @brief           Trace allocator event by USDT probe and hook.
+ *  @param[in] name  Event name, simpl_trace_##name.
+ *  @param[in] pool  Pool header.
+ *  @param[in] size  Chunk size or requested size.
+ *  @param[in] ptr   Payload.
+ *  @param[in] fi    Freelist index. */
+#define simpl_trace(name, pool, size, ptr, fi) do { \
+	simpl_usdt(name, pool, size, ptr, fi); \
+	simpl_trace_call(simpl_trace_##name, (void *)(pool), size, ptr, fi); \
+} while (0)
+
+#endif//_SIMPL_TRACE_H
@@ -0,0 +1,137 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file      simpl-uring.c
+ *  @author    Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @details
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl.h"
+#include "simpl-huge.h"
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define uring_supported
+#ifndef SYS_io_uring_register
+#define SYS_io_uring_register (427)
+#endif//SYS_io_uring_register
+/** opcodes of io_uring_register, linux/io_uring.h is not required */
+#define uring_register_buffers   (0)
+#define uring_unregister_buffers (1)
+#endif//__linux__
+
+/** granule of I/O buffers */
+#define uring_granule (4096)
+
+/** registered buffer pool, at the front of its own mapping */
+struct simpl_uring {
+	uint8_t *map;
+	size_t map_size;
+	/** granule SIMP in the mapping after this header */
+	void *oob;
+	/** ring of registered mapping, negative if not registered */
+	int ring_fd;
+};
+
+void *simpl_uring_create(int ring_fd, size_t pool_size)
+{
+	struct simpl_uring *uring;
+	size_t map_size = pool_size;
+	uint8_t *map;
+#ifdef uring_supported
+	struct iovec iov;
+#endif//uring_supported
+
+	if (!pool_size || !(map = (uint8_t *)simpl_huge_map(&map_size)))
+		return NULL;
+	uring = (struct simpl_uring *)map;
+	uring->map = map;
+	uring->map_size = map_size;
+	uring->ring_fd = -1;
+	if (!(uring->oob = simpl_oob_init(map + sizeof(struct simpl_uring), map_size - sizeof(struct simpl_uring),
+		uring_granule))) {
+		simpl_huge_unmap(map, map_size);
+		return NULL;
+	}
+	if (ring_fd < 0)
+		return uring;
+#ifdef uring_supported
+	iov.iov_base = map;
+	iov.iov_len = map_size;
+	if (!syscall(SYS_io_uring_register, ring_fd, uring_register_buffers, &iov, 1)) {
+		uring->ring_fd = ring_fd;
+		return uring;
+	}
+#endif//uring_supported
+	simpl_huge_unmap(map, map_size); /* not registered, errno kept */
+	return NULL;
+}
+
+void simpl_uring_destroy(void *uring_handle)
+{
+	struct simpl_uring *uring = (struct simpl_uring *)uring_handle;
+
+	if (!uring)
+		return;
+#ifdef uring_supported
+	if (uring->ring_fd >= 0)
+		syscall(SYS_io_uring_register, uring->ring_fd, uring_unregister_buffers, NULL, 0);
+#endif//uring_supported
+	simpl_huge_unmap(uring->map, uring->map_size);
+}
+
+int simpl_uring_malloc(void *uring_handle, size_t alloc_size, struct simpl_uring_buffer *buffer)
+{
+	struct simpl_uring *uring = (struct simpl_uring *)uring_handle;
+	void *data;
+
+	if (!uring || !buffer)
+		return -EINVAL;
+	if (!(data = simpl_oob_malloc(uring->oob, alloc_size)))
+		return -ENOMEM;
+	buffer->data = data;
+	buffer->size = simpl_oob_usable_size(uring->oob, data);
+	buffer->offset = (size_t)((uint8_t *)data - uring->map);
+	buffer->index = 0;
+	return 0;
+}
+
+void simpl_uring_free(void *uring_handle, void *data)
+{
+	struct simpl_uring *uring = (struct simpl_uring *)uring_handle;
+
+	if (uring)
+		simpl_oob_free(uring->oob, data);
+}
+
+void simpl_uring_get_stats(void *uring_handle, struct simpl_stats *stats)
+{
+	struct simpl_uring *uring = (struct simpl_uring *)uring_handle;
+
+	simpl_oob_get_stats(uring? uring->oob: NULL, stats);
+}
@@ -23,10 +23,47 @@
  *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
  *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
  *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(SIMPL_LATENCY) && !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
 #include <stddef.h>
 #include <stdint.h>
 #include <string.h>
+#include <errno.h>
 #include "simpl.h"
+#include "simpl-profile.h"
+#include "simpl-bulk.h"
+#include "simpl-snapshot.h"
+#include "simpl-trace.h"
+#include "simpl-huge.h"
+
+#ifdef SIMPL_LATENCY
+#include "simpl-latency.h"
+
+/** public entry points are compiled as untimed bodies, timed wrappers at the end */
+#define simpl_malloc   untimed_malloc
+#define simpl_free     untimed_free
+#define simpl_realloc  untimed_realloc
+#define simpl_memalign untimed_memalign
+#define simpl_calloc   untimed_calloc
+#define simpl_malloc_tagged untimed_malloc_tagged
+#define simpl_malloc_class  untimed_malloc_class
+static void *untimed_malloc(void *simp, size_t alloc_size);
+static void untimed_free(void *simp, void *simple);
+static void *untimed_realloc(void *simp, void *simple, size_t realloc_size);
+static void *untimed_memalign(void *simp, size_t align, size_t alloc_size);
+static void *untimed_calloc(void *simp, size_t nmemb, size_t size);
+static void *untimed_malloc_tagged(void *simp, size_t alloc_size, unsigned int tag);
+static void *untimed_malloc_class(void *simp, size_t chunk_size, unsigned int fi);
+#endif//SIMPL_LATENCY
+
+#ifdef SIMPL_HARDENED
+#include <stdio.h>
+#include <stdlib.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif//__linux__
+#endif//SIMPL_HARDENED
 
 #ifndef assert_msg
 #if (defined(_DEBUG) && !defined(NDEBUG))
@@ -51,6 +88,21 @@
 #endif//(_DEBUG && !NDEBUG)
 #endif//assert_msg
 
+#ifndef SIMPL_QUICK_THRESHOLD
+/** quick list length which triggers batch coalescing */
+#define SIMPL_QUICK_THRESHOLD (32)
+#endif//SIMPL_QUICK_THRESHOLD
+
+#ifndef SIMPL_BESTFIT_STEPS
+/** max chunks visited by in-class best-fit search */
+#define SIMPL_BESTFIT_STEPS (8)
+#endif//SIMPL_BESTFIT_STEPS
+
+#ifndef SIMPL_ORDERED_STEPS
+/** max chunks visited by address-ordered insertion */
+#define SIMPL_ORDERED_STEPS (8)
+#endif//SIMPL_ORDERED_STEPS
+
 #ifndef offsetof
 #define offsetof(type, member) ((size_t) &((type *)0)->member)
 #endif//offsetof
@@ -60,11 +112,11 @@
 #endif//container_of
 
 #if defined(__GNUC__) && (__GNUC__ > 3 || (__GNUC__ == 3 && __GNUC_MINOR__ >= 4)) && defined(__GNUC_PATCHLEVEL__) /* GCC 3.4 and above */
-static inline int ffs(uint32_t dw) {
+static inline int ffs32(uint32_t dw) {
 	return dw? __builtin_ffs(dw): 0;
 }
 
-static inline int fls(uint32_t dw) {
+static inline int fls32(uint32_t dw) {
 	return dw? 32 - __builtin_clz(dw): 0;
 }
 #elif defined(_MSC_VER) && (_MSC_VER >= 1400) && (defined(_M_IX86) || defined(_M_X64)) /* VS x86/x64 */
@@ -72,12 +124,12 @@ static inline int fls(uint32_t dw) {
 #pragma intrinsic(_BitScanReverse)
 #pragma intrinsic(_BitScanForward)
 
-static inline int ffs(uint32_t dw) {
+static inline int ffs32(uint32_t dw) {
 	unsigned long index;
 	return _BitScanForward(&index, dw)? index + 1: 0;
 }
 
-static inline int fls(uint32_t dw) {
+static inline int fls32(uint32_t dw) {
 	unsigned long index;
 	return _BitScanReverse(&index, dw)? index + 1: 0;
 }
@@ -95,11 +147,11 @@ static inline int fls_generic(uint32_t dw) {
 	return bit;
 }
 
-static inline int ffs(uint32_t dw) { 
+static inline int ffs32(uint32_t dw) { 
 	return fls_generic(dw & (~dw + 1));
 }
 
-static inline int fls(uint32_t dw) {
+static inline int fls32(uint32_t dw) {
 	return fls_generic(dw);
 }
 #endif
@@ -128,6 +180,40 @@ static inline int is_ptr_aligned(void *ptr, size_t align) {
 	return (((uintptr_t)ptr & (uintptr_t)align - 1) == 0);
 }
 
+#ifdef SIMPL_HARDENED
+/** per-process random secret of header cookie, seeded by first SIMP */
+static uint32_t simpl_cookie_secret;
+
+/** @brief Seed cookie secret once per process.
+ *  @note
+ *  Seed is the same value on every call, so SIMPs initialized by racing
+ *  threads agree. Linux takes the 16 random bytes of AT_RANDOM given by
+ *  kernel at exec, other platforms fall back to ASLR addresses. */
+static void seed_cookie_secret(void)
+{
+	uintptr_t seed = (uintptr_t)&simpl_cookie_secret ^ (uintptr_t)&seed_cookie_secret >> 12;
+#if defined(__linux__) && defined(AT_RANDOM)
+	const uint8_t *random = (const uint8_t *)getauxval(AT_RANDOM);
+	uint32_t bytes;
+
+	if (random) {
+		memcpy(&bytes, random + 8, sizeof(bytes)); /* first bytes are stack protector canary */
+		seed = bytes;
+	}
+#endif//__linux__ && AT_RANDOM
+	simpl_cookie_secret = (uint32_t)seed | 1;
+}
+
+/** @brief       Header cookie of chunk position.
+ *  @param chunk Chunk position.
+ *  @return      Cookie which XOR'd into chunk size. */
+static inline uint32_t chunk_cookie(const void *chunk) {
+	return (simpl_cookie_secret ^ (uint32_t)((uintptr_t)chunk >> 3)) * 0x9e3779b1U;
+}
+#else
+#define chunk_cookie(chunk) (0U)
+#endif//SIMPL_HARDENED
+
 /** <pre>
  *  +---------[CHUNK]---------+
  *  | Physical Previous Chunk |\
@@ -144,15 +230,26 @@ struct simpl_chunk {
 	/** <pre>
 	 *  chunk size first bit:  chuck free flag
 	 *  chunk size second bit: previous physical chunk free flag
-	 *  chunk size must 4 bytes aligned </pre> */
+	 *  chunk size must 4 bytes aligned
+	 *  hardened mode: stored XOR'd with chunk_cookie </pre> */
 	uint32_t size;
+#if (UINTPTR_MAX > 0xffffffffU)
+#define simpl_tag_in_header
+	/** tag of used chunk in header padding, tagged pool only */
+	uint16_t tag;
+#define get_chunk_tag(chunk) ((chunk)->tag)
+#else
+#define get_chunk_tag(chunk) (0U)
+#endif//(UINTPTR_MAX > 0xffffffffU)
+#define get_chunk_word(chunk)       ((chunk)->size ^ chunk_cookie(chunk))
+#define put_chunk_word(chunk, word) ((chunk)->size = (word) ^ chunk_cookie(chunk))
 #define chunk_flag_free_mask      (0x1U)
 #define chunk_flag_prev_free_mask (0x2U)
 #define chunk_flags_mask          (0x3U)
-#define is_chunk_free(chunk)      ((chunk)->size & chunk_flag_free_mask)   
-#define is_chunk_prev_free(chunk) ((chunk)->size & chunk_flag_prev_free_mask)   
-#define get_chunk_flags(chunk)    ((chunk)->size & chunk_flags_mask)   
-#define get_chunk_size(chunk)     ((chunk)->size & ~chunk_flags_mask)
+#define is_chunk_free(chunk)      (get_chunk_word(chunk) & chunk_flag_free_mask)   
+#define is_chunk_prev_free(chunk) (get_chunk_word(chunk) & chunk_flag_prev_free_mask)   
+#define get_chunk_flags(chunk)    (get_chunk_word(chunk) & chunk_flags_mask)   
+#define get_chunk_size(chunk)     (get_chunk_word(chunk) & ~chunk_flags_mask)
 	union {
 		/** C++ not allow zero-sized array */
 		uint8_t payload[1];
@@ -164,6 +261,83 @@ struct simpl_chunk {
 	};
 };
 
+/** exact-size list of chunks with deferred coalescing,
+ *  chunks in quick list keep used flag and link by free_next */
+struct simpl_quick {
+	struct simpl_chunk *head;
+	uint32_t count;
+};
+
+/** live bytes and budget of tag */
+struct simpl_tag {
+	uint32_t usage;
+	/** 0 for unlimited */
+	uint32_t budget;
+};
+
+/** handle of relocatable SIMPL element, payload NULL when unused */
+struct simpl_handle_entry {
+	void *payload;
+	uint32_t locks;
+	/** next unused entry index + 1, 0 for end */
+	uint32_t next;
+};
+
+/** <pre>
+ *  handle table is an used chunk of pool, grows by doubling,
+ *  payload of handle chunk starts with its entry index. </pre> */
+struct simpl_handles {
+	uint32_t capacity;
+	/** first unused entry index + 1, 0 for full */
+	uint32_t unused;
+	struct simpl_handle_entry entry[1];
+};
+
+/** <pre>
+ *  region added to child SIMP from its parent, payload of a parent chunk,
+ *  chunks of region never coalesce across its bounds:
+ *  +--------[REGION]---------+
+ *  |  Next, First, End       |
+ *  +---------[CHUNK]---------+
+ *  |                Size |0|F|   first chunk, always prev used
+ *  |           ...           |
+ *  +---------[CHUNK]---------+
+ *  |                   0 |P|0|   end chunk like tail, always used
+ *  +-------------------------+ </pre> */
+struct simpl_region {
+	struct simpl_region *next;
+	struct simpl_chunk *first;
+	struct simpl_chunk *end;
+};
+
+/** latency histograms take at most 1/simplc_latency_ratio of SIMP */
+#define simplc_latency_ratio (64)
+
+/** latency histograms of pool, SIMPL_LATENCY only */
+struct simpl_latency {
+	/** slow path taken by current simpl_realloc, simpl_latency_realloc if none */
+	uint32_t path;
+	struct simpl_latency_histogram histograms[simpl_latency_ops];
+};
+
+/** <pre>
+ *  huge block is mapped outside pool, its pseudo chunk header
+ *  (free chunk of size zero) never appears in pool. </pre> */
+struct simpl_huge {
+	struct simpl_huge *prev;
+	struct simpl_huge *next;
+	/** bytes of mapping */
+	size_t map_size;
+	/** non-zero if mapped by registry, found by simpl_pool_of */
+	size_t registered;
+	struct simpl_chunk chunk;
+};
+
+#define simplc_huge_word     (chunk_flag_free_mask)
+#define simplc_huge_overhead (offsetof(struct simpl_huge, chunk) + offsetof(struct simpl_chunk, payload))
+/** freelist index of huge block in trace events */
+#define simplc_huge_index    (UINT32_MAX)
+
 /** <pre>
  *  |------------------------[BITMAP]------------------------| (index: 0 ~ 191, 1G: 0 ~ 175)
  *  |23|2048M|2304M|2560M|2816M|3072M|3328M|3584M|3840M|+256M| 1XXX .... .... .... .... .... .... ..00
@@ -200,6 +374,47 @@ struct simpl_pool {
 	uint32_t fl_bitmap;
 	uint8_t *sl_bitmaps;
 	struct simpl_chunk **freelists;
+	/** first physical chunk, always prev used */
+	struct simpl_chunk *first;
+	/** tail chunk (size zero), always used */
+	struct simpl_chunk *tail;
+	/** innermost checkpoint, NULL when no checkpoint */
+	struct simpl_mark *mark;
+	/** simpl_flags of pool */
+	uint32_t flags;
+	/** bytes held by quick lists */
+	uint32_t deferred;
+	/** quick lists, NULL when coalescing not deferred */
+	struct simpl_quick *quick;
+	/** free chunk before tail which kept out of freelists, address-ordered only */
+	struct simpl_chunk *wilderness;
+	/** sampling heap profile, NULL when not profiling */
+	struct simpl_profile *profile;
+	/** SIMPL_TAGS counters, NULL when not tagged */
+	struct simpl_tag *tags;
+	/** handle table, NULL before first simpl_halloc */
+	struct simpl_handles *handles;
+	/** chunk where incremental compaction resumes, NULL to start from first */
+	struct simpl_chunk *compact;
+	/** huge blocks, newest first */
+	struct simpl_huge *huge;
+	/** SIZE_MAX when huge blocks disabled */
+	size_t huge_threshold;
+	/** bytes of huge block mappings */
+	size_t huge_bytes;
+	/** parent SIMP of child, NULL otherwise */
+	struct simpl_pool *parent;
+	/** regions taken from parent, newest first */
+	struct simpl_region *regions;
+	/** bytes of region taken from parent, buffer size of child */
+	size_t region_size;
+	/** child SIMPs in elements of this pool, newest first */
+	struct simpl_pool *children;
+	/** next child of the same parent */
+	struct simpl_pool *sibling;
+#ifdef SIMPL_LATENCY
+	struct simpl_latency *latency;
+#endif//SIMPL_LATENCY
 #define simplc_fl_shift              (0x3)
 #define simplc_sl_mask               (0x7)
 #define get_fl_index(fi)             ((fi) >> simplc_fl_shift)
@@ -218,68 +433,101 @@ enum simpl_const {
 	simplc_4MB_size      = 1U << simplc_4MB_shift,
 	simplc_max_flsize    = 24,
 	simplc_max_freelists = simplc_max_flsize * simplc_bits_per_byte,
+	simplc_small_size    = 1024,
 
 	simplc_chunk_overlap_size = offsetof(struct simpl_chunk, size),
 	simplc_chunk_overhead     = offsetof(struct simpl_chunk, payload) - simplc_chunk_overlap_size,
 	simplc_chunk_min_size     = sizeof(struct simpl_chunk) - simplc_chunk_overhead,
 #define simplc_chunk_max_size (UINT32_MAX)
+
+	simplc_quick_max_size = 512,
+	simplc_quick_lists    = (simplc_quick_max_size - simplc_chunk_min_size) / simplc_bytes_per_ptr + 1,
+};
+
+#define get_quick_index(size) (((size) - simplc_chunk_min_size) / simplc_bytes_per_ptr)
+
+/** <pre>
+ *  +---------[CHUNK]---------+
+ *  |                Size |P|0|   checkpoint is an used chunk carved from
+ *  +~~~~~~~~[PAYLOAD]~~~~~~~~+   the front of the largest free chunk,
+ *  |     Previous Checkpoint |   the rest of the free chunk is the only
+ *  +-------------------------+   free memory until released.
+ *  |       Region End Chunk  |
+ *  +-------------------------+
+ *  |  Saved Pool State ...   |
+ *  +-------------------------+ </pre> */
+struct simpl_mark {
+	struct simpl_mark *prev;
+	/** physical chunk which follows the checkpoint region */
+	struct simpl_chunk *end;
+	struct simpl_chunk *wilderness;
+	/** huge blocks before checkpoint */
+	struct simpl_huge *huge;
+	uint32_t available;
+	uint32_t fl_bitmap;
+	uint8_t sl_bitmaps[simplc_max_flsize];
+	/** <pre>
+	 *  heads of saved freelists, ordered by bitmap index,
+	 *  followed by tag usage when tagged </pre> */
+	struct simpl_chunk *heads[1];
 };
 
+/** <pre>
+ *  compile-time fls and mapping of small size (< simplc_small_size),
+ *  same as freelists_mapping of first tier </pre> */
+#define const_fls8(s) ((s) >= 128? 8: (s) >= 64? 7: (s) >= 32? 6: (s) >= 16? 5: \
+	(s) >= 8? 4: (s) >= 4? 3: (s) >= 2? 2: (s))
+#define const_mapping(s) (const_fls8(s) > 3? \
+	get_freelist_index(const_fls8(s) - 3, ((s) >> (const_fls8(s) - 4)) & simplc_sl_mask): (s) & simplc_sl_mask)
+#define const_mapping4(s)   const_mapping(s), const_mapping((s) + 1), const_mapping((s) + 2), const_mapping((s) + 3)
+#define const_mapping16(s)  const_mapping4(s), const_mapping4((s) + 4), const_mapping4((s) + 8), const_mapping4((s) + 12)
+#define const_mapping64(s)  const_mapping16(s), const_mapping16((s) + 16), const_mapping16((s) + 32), const_mapping16((s) + 48)
+#define const_mapping256(s) const_mapping64(s), const_mapping64((s) + 64), const_mapping64((s) + 128), const_mapping64((s) + 192)
+
+/** freelists index of small size, indexed by size >> simplc_4B_shift */
+static const uint8_t small_mapping[simplc_small_size >> simplc_4B_shift] = { const_mapping256(0) };
+
 /** @brief      Size and freelists index mapping.
- *  @param pool Pool header.
  *  @param size Adjusted chunk size.
  *  @return     The size and freelists index mapping.
- *  @note       size can't over UINT32_MAX. */
-static uint32_t freelists_mapping(uint32_t size)
+ *  @note
+ *  1. size can't over UINT32_MAX.
+ *  2. Tier is selected by compare instead of branch, single fls for all tiers. */
+static inline uint32_t freelists_mapping(uint32_t size)
 {
-	uint32_t fli, sli;
+	uint32_t tier, shift, fli;
 	int ls;
 
-	if (size < simplc_4kB_size) {
-		fli = 0;
-		size >>= simplc_4B_shift;
-	} else if (size < simplc_4MB_size) {
-		fli = 8;
-		size >>= simplc_4kB_shift;
-	} else {
-		fli = 16;
-		size >>= simplc_4MB_shift;
-	}
-
-	ls = fls(size);
-	if (ls > 3) {
-		fli += ls - 3;
-		sli = (size >> (ls - 4)) & simplc_sl_mask;
-	} else {
-		sli = size & simplc_sl_mask;
-	}
-
-	return get_freelist_index(fli, sli);
+	if (size < simplc_small_size)
+		return small_mapping[size >> simplc_4B_shift];
+	tier = (size >= simplc_4kB_size) + (size >= simplc_4MB_size);
+	shift = simplc_4B_shift + tier * (simplc_4kB_shift - simplc_4B_shift);
+	size >>= shift;
+	ls = fls32(size);
+	fli = tier * simplc_bits_per_byte + (ls > 3? ls - 3: 0);
+	return get_freelist_index(fli, (size >> (ls > 4? ls - 4: 0)) & simplc_sl_mask);
 }
 
-/** @brief    Get size of freelists mapping.
- *  @param fi The size and freelists index mapping.
- *  @return   The size of mapping */
-static uint32_t mapping_size(uint32_t fi)
+/** @brief           Fused round up and mapping for good-fit search.
+ *  @param[in] size  Adjusted chunk size.
+ *  @param[out] round Lower bound of size class which all chunks fit \p size.
+ *  @return          The freelists index of \p round, 0 if round over UINT32_MAX.
+ *  @note            Size class width of \p size is the rounding granule. */
+static inline uint32_t roundup_mapping(uint32_t size, uint32_t *round)
 {
-	uint32_t size, size_shift, fli_local, fli = get_fl_index(fi);
-
-	if (fli < 8) {
-		fli_local = fli;
-		size_shift = 0;
-	} else if (fli < 16) {
-		fli_local = fli - 8;
-		size_shift = 10;
-	} else {
-		fli_local = fli - 16;
-		size_shift = 20;
-	}
+	uint32_t tier, shift;
+	uint64_t granule;
+	int ls;
 
-	if (fli_local == 0 && get_sl_index(fi) == 0)
+	tier = (size >= simplc_4kB_size) + (size >= simplc_4MB_size);
+	shift = simplc_4B_shift + tier * (simplc_4kB_shift - simplc_4B_shift);
+	ls = fls32(size >> shift);
+	granule = (uint64_t)1 << (shift + (ls > 4? ls - 4: 0));
+	granule = ((uint64_t)size + granule - 1) & ~(granule - 1);
+	if (granule > simplc_chunk_max_size)
 		return 0;
-	size = fli_local? 32 << (fli_local - 1): 0;
-	size += get_sl_index(fi) * (size? size >> 3: 4);
-	return size <<= size_shift;
+	*round = (uint32_t)granule;
+	return freelists_mapping(*round);
 }
 
 static inline uint32_t adjust_alloc_size(size_t alloc_size, size_t align) {
@@ -298,7 +546,7 @@ static inline uint32_t adjust_alloc_size(size_t alloc_size, size_t align) {
 
 static inline void set_chunk_size(struct simpl_chunk *chunk, uint32_t size) {
 	assert_msg(!(size & chunk_flags_mask), "size(%d) invalid.", size);
-	chunk->size = size | get_chunk_flags(chunk);
+	put_chunk_word(chunk, size | get_chunk_flags(chunk));
 }
 
 static inline struct simpl_chunk *prev_phys_chunk(struct simpl_chunk *chunk) {
@@ -311,13 +559,19 @@ static inline struct simpl_chunk *next_phys_chunk(struct simpl_chunk *chunk) {
 }
 
 static inline void set_chunk_free(struct simpl_chunk *chunk) {
-	chunk->size |= chunk_flag_free_mask;
-	next_phys_chunk(chunk)->size |= chunk_flag_prev_free_mask;
+	struct simpl_chunk *next;
+
+	put_chunk_word(chunk, get_chunk_word(chunk) | chunk_flag_free_mask);
+	next = next_phys_chunk(chunk);
+	put_chunk_word(next, get_chunk_word(next) | chunk_flag_prev_free_mask);
 }
 
 static inline void set_chunk_used(struct simpl_chunk *chunk) {
-	chunk->size &= ~chunk_flag_free_mask;
-	next_phys_chunk(chunk)->size &= ~chunk_flag_prev_free_mask;
+	struct simpl_chunk *next;
+
+	put_chunk_word(chunk, get_chunk_word(chunk) & ~chunk_flag_free_mask);
+	next = next_phys_chunk(chunk);
+	put_chunk_word(next, get_chunk_word(next) & ~chunk_flag_prev_free_mask);
 }
 
 static inline void *get_chunk_payload(struct simpl_chunk *chunk) {
@@ -328,6 +582,121 @@ static inline struct simpl_chunk *get_payload_chunk(void *payload) {
 	return container_of(payload, struct simpl_chunk, payload);
 }
 
+#ifdef SIMPL_HARDENED
+static simpl_corruption_handler corruption_handler = NULL;
+
+/** @brief           Report heap corruption.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The corrupted chunk.
+ *  @param[in] what  Description of corruption.
+ *  @note            Abort if no handler set. */
+static void report_corruption(struct simpl_pool *pool, struct simpl_chunk *chunk, const char *what)
+{
+	if (corruption_handler) {
+		corruption_handler(pool, chunk, what);
+		return;
+	}
+	fprintf(stderr, "simpl: %s (pool %p, chunk %p)\n", what, (void *)pool, (void *)chunk);
+	abort();
+}
+
+#define check_chunk(cond, pool, chunk, what) \
+	((cond)? 1: (report_corruption(pool, chunk, what), 0))
+#else
+#define check_chunk(cond, pool, chunk, what) (1)
+#endif//SIMPL_HARDENED
+
+void simpl_set_corruption_handler(simpl_corruption_handler handler)
+{
+#ifdef SIMPL_HARDENED
+	corruption_handler = handler;
+#else
+	(void)handler;
+#endif//SIMPL_HARDENED
+}
+
+#ifdef simpl_usdt_enabled
+simpl_usdt_define(malloc);
+simpl_usdt_define(free);
+simpl_usdt_define(realloc);
+simpl_usdt_define(memalign);
+simpl_usdt_define(split);
+simpl_usdt_define(merge);
+simpl_usdt_define(fail);
+#endif//simpl_usdt_enabled
+
+#ifdef SIMPL_TRACE_HOOKS
+simpl_trace_hook simpl_trace_hook_fn = NULL;
+#endif//SIMPL_TRACE_HOOKS
+
+void simpl_set_trace_hook(simpl_trace_hook hook)
+{
+#ifdef SIMPL_TRACE_HOOKS
+	simpl_trace_hook_fn = hook;
+#else
+	(void)hook;
+#endif//SIMPL_TRACE_HOOKS
+}
+
+#ifdef SIMPL_HARDENED
+/** @brief           Find bounds of region which contains chunk.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The chunk.
+ *  @param[out] end  End chunk of region, pool tail for pool buffer.
+ *  @return          First chunk of region, NULL if chunk out of pool. */
+static struct simpl_chunk *chunk_region(struct simpl_pool *pool, struct simpl_chunk *chunk, struct simpl_chunk **end)
+{
+	struct simpl_region *region;
+
+	if (chunk >= pool->first && chunk < pool->tail) {
+		*end = pool->tail;
+		return pool->first;
+	}
+	for (region = pool->regions; region; region = region->next) {
+		if (chunk >= region->first && chunk < region->end) {
+			*end = region->end;
+			return region->first;
+		}
+	}
+	return NULL;
+}
+#endif//SIMPL_HARDENED
+
+/** @brief           Validate chunk which be freed or reallocated.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The chunk which should be used.
+ *  @return          Non-zero if valid, always valid when not hardened. */
+static inline int check_used_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk)
+{
+#ifdef SIMPL_HARDENED
+	struct simpl_chunk *next, *prev, *first, *end = NULL;
+	uint32_t word;
+
+	first = chunk_region(pool, chunk, &end);
+	if (!check_chunk(first && is_ptr_aligned(chunk, simplc_bytes_per_ptr), pool, chunk, "invalid pointer"))
+		return 0;
+	word = get_chunk_word(chunk);
+	if (!check_chunk(!(word & chunk_flag_free_mask), pool, chunk, "double free"))
+		return 0;
+	next = (struct simpl_chunk *)((uint8_t *)chunk + simplc_chunk_overhead + (word & ~chunk_flags_mask));
+	if (!check_chunk(!(word & (simplc_bytes_per_ptr - 1) & ~chunk_flags_mask) &&
+		(word & ~chunk_flags_mask) >= simplc_chunk_min_size && next <= end && next > chunk &&
+		!is_chunk_prev_free(next), pool, chunk, "corrupted size"))
+		return 0;
+	if (word & chunk_flag_prev_free_mask) {
+		prev = chunk->phys_prev;
+		if (!check_chunk(prev >= first && prev < chunk && is_chunk_free(prev) &&
+			next_phys_chunk(prev) == chunk, pool, chunk, "corrupted previous chunk"))
+			return 0;
+	}
+#ifdef simpl_tag_in_header
+	if (!check_chunk(!pool->tags || chunk->tag < SIMPL_TAGS, pool, chunk, "corrupted tag"))
+		return 0;
+#endif//simpl_tag_in_header
+#endif//SIMPL_HARDENED
+	return 1;
+}
+
 static inline void set_bitmap(struct simpl_pool *pool, uint32_t fi) {
 	uint32_t fli = get_fl_index(fi);
 	pool->fl_bitmap |= 1U << fli;
@@ -341,17 +710,27 @@ static void push_free_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk)
 {
 	uint32_t chunk_size = get_chunk_size(chunk);
 	uint32_t fi = freelists_mapping(chunk_size);
-	struct simpl_chunk *head = pool->freelists[fi];
+	struct simpl_chunk *prev = NULL, *next = pool->freelists[fi];
+	int steps = SIMPL_ORDERED_STEPS;
 
 	assert_msg(is_chunk_free(chunk), "chunk must freed.");
-	if (head)
-		head->free_prev = chunk;
-	chunk->free_prev = NULL;
-	chunk->free_next = head;
-	pool->freelists[fi] = chunk;
-	set_bitmap(pool, fi);
-
 	pool->available += chunk_size;
+	if (pool->flags & simpl_flag_address_ordered) {
+		if (next_phys_chunk(chunk) == pool->tail) { /* keep wilderness in reserve */
+			pool->wilderness = chunk;
+			return;
+		}
+		for (; next && next < chunk && steps--; prev = next, next = next->free_next);
+	}
+	if (next)
+		next->free_prev = chunk;
+	chunk->free_prev = prev;
+	chunk->free_next = next;
+	if (prev)
+		prev->free_next = chunk;
+	else
+		pool->freelists[fi] = chunk;
+	set_bitmap(pool, fi);
 }
 
 static inline void clr_bitmap(struct simpl_pool *pool, uint32_t fi) {
@@ -372,35 +751,56 @@ static void pop_free_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk)
 	struct simpl_chunk *next = chunk->free_next;
 
 	assert_msg(is_chunk_free(chunk), "chunk must freed.");
+	if (chunk == pool->wilderness) {
+		pool->wilderness = NULL;
+		pool->available -= chunk_size;
+		return;
+	}
+	if (!check_chunk(prev? prev->free_next == chunk: pool->freelists[fi] == chunk, pool, chunk, "corrupted free previous") ||
+		!check_chunk(!next || next->free_prev == chunk, pool, chunk, "corrupted free next"))
+		return;
 	if (prev)
 		prev->free_next = next;
 	else
 		pool->freelists[fi] = next;
 	if (next)
 		next->free_prev = prev;
-	else
+	if (!pool->freelists[fi]) /* list may continue before chunk */
 		clr_bitmap(pool, fi);
 
 	pool->available -= chunk_size;
 }
 
-void *simpl_init(void *buffer, size_t buffer_size)
+/** @brief                 Initialize pool in buffer.
+ *  @param[in] buffer      Memory buffer.
+ *  @param[in] buffer_size Size of buffer.
+ *  @param[in] flags       simpl_flags.
+ *  @param[in] est         Number of freelists, 0 to size by buffer.
+ *  @return                Pool header, NULL if buffer too small. */
+static void *init_pool(void *buffer, size_t buffer_size, unsigned int flags, uint32_t est)
 {
 	const uint8_t *end = (uint8_t *)ptr_align_down((uint8_t *)buffer + buffer_size, simplc_bytes_per_ptr);
 	struct simpl_pool *pool;
 	struct simpl_chunk *chunk;
 	uint8_t *p;
-	uint32_t i, est, sl_size, size;
+	uint32_t i, sl_size, size;
 
 	if (!buffer || !buffer_size || (buffer_size > simplc_chunk_max_size))
 		return NULL;
+#ifdef SIMPL_HARDENED
+	if (!simpl_cookie_secret)
+		seed_cookie_secret();
+#endif//SIMPL_HARDENED
 	p = (uint8_t *)ptr_align_up(buffer, simplc_bytes_per_ptr);
 	pool = (struct simpl_pool *)p;
 
 	p = p + sizeof(struct simpl_pool);
 	pool->sl_bitmaps = p;
 
-	est = freelists_mapping((uint32_t)(end - p)) + 1;
+	if (!est)
+		est = freelists_mapping((uint32_t)(end - p)) + 1;
+	assert_msg(est > freelists_mapping((uint32_t)(end - p)),
+		"est(%d) should index the whole pool.", est);
 	sl_size = (est + simplc_bits_per_byte - 1) / simplc_bits_per_byte;
 	assert_msg(est <= simplc_max_freelists,
 		"est(%d) should not greater than const(%d).", est, simplc_max_freelists);
@@ -410,6 +810,26 @@ void *simpl_init(void *buffer, size_t buffer_size)
 	pool->freelists = (struct simpl_chunk **)p;
 
 	p = (uint8_t *)ptr_align_up(p + est * simplc_bytes_per_ptr, simplc_bytes_per_ptr);
+	pool->quick = NULL;
+	if (flags & simpl_flag_defer_coalescing) {
+		pool->quick = (struct simpl_quick *)p;
+		p = (uint8_t *)ptr_align_up(p + simplc_quick_lists * sizeof(struct simpl_quick), simplc_bytes_per_ptr);
+	}
+	pool->tags = NULL;
+	if (flags & simpl_flag_tagged) {
+#ifndef simpl_tag_in_header
+		return NULL; /* no header padding for tag */
+#endif//simpl_tag_in_header
+		pool->tags = (struct simpl_tag *)p;
+		p = (uint8_t *)ptr_align_up(p + SIMPL_TAGS * sizeof(struct simpl_tag), simplc_bytes_per_ptr);
+	}
+#ifdef SIMPL_LATENCY
+	pool->latency = NULL;
+	if ((size_t)(end - p) / simplc_latency_ratio >= sizeof(struct simpl_latency)) {
+		pool->latency = (struct simpl_latency *)p;
+		p = (uint8_t *)ptr_align_up(p + sizeof(struct simpl_latency), simplc_bytes_per_ptr);
+	}
+#endif//SIMPL_LATENCY
 	if (p > end)
 		return NULL;
 	size = (uint32_t)(end - p);
@@ -421,57 +841,305 @@ void *simpl_init(void *buffer, size_t buffer_size)
 		pool->sl_bitmaps[i] = 0;
 	for (i = 0; i < est; i++)
 		pool->freelists[i] = NULL;
+	if (pool->quick)
+		memset(pool->quick, 0, simplc_quick_lists * sizeof(struct simpl_quick));
+	if (pool->tags)
+		memset(pool->tags, 0, SIMPL_TAGS * sizeof(struct simpl_tag));
+#ifdef SIMPL_LATENCY
+	if (pool->latency)
+		memset(pool->latency, 0, sizeof(struct simpl_latency));
+#endif//SIMPL_LATENCY
+	pool->mark = NULL;
+	pool->flags = flags;
+	pool->deferred = 0;
+	pool->wilderness = NULL;
+	pool->profile = NULL;
+	pool->handles = NULL;
+	pool->compact = NULL;
+	pool->huge = NULL;
+	pool->huge_threshold = SIZE_MAX;
+	pool->huge_bytes = 0;
+	pool->parent = NULL;
+	pool->regions = NULL;
+	pool->region_size = 0;
+	pool->children = NULL;
+	pool->sibling = NULL;
 
 	chunk = (struct simpl_chunk *)(p - simplc_chunk_overlap_size);
-	chunk->size = size - simplc_chunk_overhead * 2; /* always prev used */
+	put_chunk_word(chunk, size - simplc_chunk_overhead * 2); /* always prev used */
 	assert_msg(!is_chunk_prev_free(chunk),
 		"first chunk must always prev used");
-	next_phys_chunk(chunk)->size = 0; /* tail always used, and don't care phy_prev */
+	pool->first = chunk;
+	pool->tail = next_phys_chunk(chunk);
+	put_chunk_word(pool->tail, 0); /* tail always used */
+	pool->tail->phys_prev = chunk;
 	set_chunk_free(chunk);
 	push_free_chunk(pool, chunk);
 	return pool;
 }
 
-static inline uint32_t size_roundup(uint32_t size)
+void *simpl_init_ex(void *buffer, size_t buffer_size, unsigned int flags)
 {
-	uint32_t fi = freelists_mapping(size);
-	if (!fi)
-		return 0;
+	return init_pool(buffer, buffer_size, flags, 0);
+}
+
+void *simpl_init_static(void *buffer, size_t buffer_size, unsigned int flags, unsigned int freelists)
+{
+	if (!freelists || freelists > simplc_max_freelists)
+		return NULL;
+	return init_pool(buffer, buffer_size, flags, freelists);
+}
 
-	if (size <= mapping_size(fi))
-		return size;
-	size = mapping_size(fi + 1);
-	return size? size: mapping_size(fi + 2); /** Gap of local fli and sli are zero */
+void *simpl_init(void *buffer, size_t buffer_size)
+{
+	return simpl_init_ex(buffer, buffer_size, 0);
 }
 
-/** @brief          Search available chunk from freelists.
+/** @brief          Empty freelists, only the set bitmaps are visited.
+ *  @param[in] pool Pool header. */
+static void clear_freelists(struct simpl_pool *pool)
+{
+	uint32_t fl_bitmap = pool->fl_bitmap, sl_bitmap;
+	int fli, sli;
+
+	while ((fli = ffs32(fl_bitmap))) {
+		fl_bitmap &= fl_bitmap - 1;
+		sl_bitmap = pool->sl_bitmaps[--fli];
+		while ((sli = ffs32(sl_bitmap))) {
+			sl_bitmap &= sl_bitmap - 1;
+			pool->freelists[get_freelist_index(fli, sli - 1)] = NULL;
+		}
+		pool->sl_bitmaps[fli] = 0;
+	}
+	pool->fl_bitmap = 0;
+	pool->available = 0;
+	pool->wilderness = NULL;
+}
+
+#ifdef SIMPL_LATENCY
+/** slow path of simpl_realloc, recorded separately */
+#define latency_path(pool, op) ((pool)->latency? (void)((pool)->latency->path = (op)): (void)0)
+#else
+#define latency_path(pool, op) ((void)0)
+#endif//SIMPL_LATENCY
+
+/** clamp huge size for profile samples */
+#define huge_profile_size(size) ((size) > UINT32_MAX? UINT32_MAX: (uint32_t)(size))
+
+/** @brief          Map huge block outside pool.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Size of SIMPL element.
+ *  @return         Payload, NULL if mapping failed. */
+static void *malloc_huge(struct simpl_pool *pool, size_t size)
+{
+	struct simpl_huge *huge;
+	size_t map_size = simplc_huge_overhead + size;
+	size_t registered;
+
+	if (map_size < size)
+		return NULL;
+	registered = simpl_pool_of(pool) != NULL; /* simpl_free_any finds pool of huge block */
+	if (registered)
+		huge = (struct simpl_huge *)simpl_registry_map_huge(pool, &map_size);
+	else
+		huge = (struct simpl_huge *)simpl_huge_map(&map_size);
+	if (!huge)
+		return NULL;
+	huge->map_size = map_size;
+	huge->registered = registered;
+	huge->prev = NULL;
+	huge->next = pool->huge;
+	if (pool->huge)
+		pool->huge->prev = huge;
+	pool->huge = huge;
+	pool->huge_bytes += map_size;
+	put_chunk_word(&huge->chunk, simplc_huge_word);
+	return get_chunk_payload(&huge->chunk);
+}
+
+/** @brief           Get huge block of chunk.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk Chunk of SIMPL element.
+ *  @return          Huge block, NULL if chunk in pool. */
+static inline struct simpl_huge *chunk_huge(struct simpl_pool *pool, struct simpl_chunk *chunk)
+{
+	struct simpl_huge *huge;
+
+	if (!pool->huge || get_chunk_word(chunk) != simplc_huge_word)
+		return NULL;
+	huge = container_of(chunk, struct simpl_huge, chunk);
+	if (!check_chunk(huge->prev? huge->prev->next == huge: pool->huge == huge, pool, chunk, "corrupted huge block"))
+		return NULL;
+	return huge;
+}
+
+/** @brief          Unmap huge block.
+ *  @param[in] pool Pool header.
+ *  @param[in] huge Huge block. */
+static void free_huge(struct simpl_pool *pool, struct simpl_huge *huge)
+{
+	if (pool->profile)
+		simpl_profile_erase(pool->profile, get_chunk_payload(&huge->chunk));
+	if (huge->prev)
+		huge->prev->next = huge->next;
+	else
+		pool->huge = huge->next;
+	if (huge->next)
+		huge->next->prev = huge->prev;
+	pool->huge_bytes -= huge->map_size;
+	if (huge->registered)
+		simpl_registry_unmap_huge(huge, huge->map_size);
+	else
+		simpl_huge_unmap(huge, huge->map_size);
+}
+
+/** @brief          Resize huge block by remapping pages.
+ *  @param[in] pool Pool header.
+ *  @param[in] huge Huge block.
+ *  @param[in] size Size of SIMPL element.
+ *  @return         Payload which may moved, NULL if failed and block kept. */
+static void *realloc_huge(struct simpl_pool *pool, struct simpl_huge *huge, size_t size)
+{
+	size_t map_size = simplc_huge_overhead + size;
+
+	if (map_size < size)
+		return NULL;
+	if (huge->registered)
+		huge = (struct simpl_huge *)simpl_registry_remap_huge(pool, huge, huge->map_size, &map_size);
+	else
+		huge = (struct simpl_huge *)simpl_huge_remap(huge, huge->map_size, &map_size);
+	if (!huge)
+		return NULL;
+	pool->huge_bytes += map_size - huge->map_size;
+	huge->map_size = map_size;
+	if (huge->prev)
+		huge->prev->next = huge;
+	else
+		pool->huge = huge;
+	if (huge->next)
+		huge->next->prev = huge;
+	put_chunk_word(&huge->chunk, simplc_huge_word); /* cookie follows address */
+	return get_chunk_payload(&huge->chunk);
+}
+
+/** @brief            Make whole region one free chunk.
+ *  @param[in] pool   Pool header.
+ *  @param[in] region Region of child SIMP. */
+static void reset_region(struct simpl_pool *pool, struct simpl_region *region)
+{
+	struct simpl_chunk *chunk = region->first;
+
+	put_chunk_word(chunk, (uint32_t)((uint8_t *)region->end - (uint8_t *)chunk) - simplc_chunk_overhead); /* always prev used */
+	put_chunk_word(region->end, 0);
+	region->end->phys_prev = chunk;
+	set_chunk_free(chunk);
+	push_free_chunk(pool, chunk);
+}
+
+/** @brief          Take one more region from parent, child SIMP only.
  *  @param[in] pool Pool header.
  *  @param[in] size Adjusted chunk size which be required.
- *  @return         Freelists index.
+ *  @return         Non-zero if grown.
  *  @note
- *  \p size can't over UINT32_MAX. */
-static uint32_t search_freelists(struct simpl_pool *pool, uint32_t size)
+ *  Free chunk of region is as large as the first chunk of child, so child freelists index it. */
+static int grow_child(struct simpl_pool *pool, uint32_t size)
 {
-	uint32_t round, fi, fli, sli;
-	int fs;
+	struct simpl_region *region;
+	uint32_t chunk_size;
 
-	round = size? size_roundup(size): 0;
-	if (!round || round > pool->available)
+	if (!pool->parent || pool->mark || pool->parent->mark) /* checkpoint restores freelists without region */
 		return 0;
-	if (!(fi = freelists_mapping(round)))
+	chunk_size = (uint32_t)(pool->region_size - sizeof(struct simpl_region) - simplc_chunk_overhead * 2);
+	if (size > chunk_size || !(region = (struct simpl_region *)simpl_malloc(pool->parent, pool->region_size)))
 		return 0;
+	region->first = (struct simpl_chunk *)((uint8_t *)(region + 1) - simplc_chunk_overlap_size);
+	region->end = (struct simpl_chunk *)((uint8_t *)region->first + simplc_chunk_overhead + chunk_size);
+	region->next = pool->regions;
+	pool->regions = region;
+	put_chunk_word(region->first, 0); /* prev used */
+	reset_region(pool, region);
+	return 1;
+}
+
+void simpl_reset(void *simp)
+{
+	struct simpl_pool *pool, *child;
+	struct simpl_chunk *chunk;
+	struct simpl_region *region;
+	uint32_t i;
+
+	if (!simp)
+		return;
+	pool = (struct simpl_pool *)simp;
+	for (child = pool->children; child; child = child->sibling)
+		simpl_reset(child); /* huge blocks of children are outside pool */
+	clear_freelists(pool);
+	if (pool->quick)
+		memset(pool->quick, 0, simplc_quick_lists * sizeof(struct simpl_quick));
+	pool->deferred = 0;
+	pool->mark = NULL;
+	pool->profile = NULL; /* profile and handle table dropped with pool */
+	pool->handles = NULL;
+	pool->compact = NULL;
+	pool->children = NULL; /* children dropped with their elements */
+	while (pool->huge)
+		free_huge(pool, pool->huge);
+	for (i = 0; pool->tags && i < SIMPL_TAGS; i++)
+		pool->tags[i].usage = 0;
+
+	chunk = pool->first;
+	put_chunk_word(chunk, (uint32_t)((uint8_t *)pool->tail - (uint8_t *)chunk) - simplc_chunk_overhead); /* always prev used */
+	put_chunk_word(pool->tail, 0);
+	pool->tail->phys_prev = chunk;
+	set_chunk_free(chunk);
+	push_free_chunk(pool, chunk);
+	for (region = pool->regions; region; region = region->next)
+		reset_region(pool, region);
+}
+
+/** @brief          Search best-fit chunk in the size class of required size.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Adjusted chunk size which be required.
+ *  @return         The smallest fit chunk of first SIMPL_BESTFIT_STEPS chunks, NULL if not found. */
+static struct simpl_chunk *search_size_class(struct simpl_pool *pool, uint32_t size)
+{
+	struct simpl_chunk *chunk, *fit = NULL;
+	uint32_t chunk_size, fit_size = simplc_chunk_max_size;
+	int steps = SIMPL_BESTFIT_STEPS;
+
+	for (chunk = pool->freelists[freelists_mapping(size)]; chunk && steps--; chunk = chunk->free_next) {
+		chunk_size = get_chunk_size(chunk);
+		if (chunk_size >= size && chunk_size < fit_size) {
+			fit = chunk;
+			fit_size = chunk_size;
+			if (fit_size == size)
+				break;
+		}
+	}
+	return fit;
+}
+
+/** @brief          Search first non-empty freelist from size class.
+ *  @param[in] pool Pool header.
+ *  @param[in] fi   Freelists index which all chunks fit.
+ *  @return         Head of the freelist, NULL if not found. */
+static struct simpl_chunk *search_from_class(struct simpl_pool *pool, uint32_t fi)
+{
+	uint32_t fli, sli;
+	int fs;
+
 	fli = get_fl_index(fi);
 	sli = get_sl_index(fi);
 
-	fs = ffs(pool->sl_bitmaps[fli] & (~0U << sli));
+	fs = ffs32(pool->sl_bitmaps[fli] & (~0U << sli));
 	if (fs) {
 		sli = fs - 1;
 	} else {
-		fs = ffs(pool->fl_bitmap & (~0U << (fli + 1)));
+		fs = ffs32(pool->fl_bitmap & (~0U << (fli + 1)));
 		if (!fs) /* not found */
-			return 0;
+			return NULL;
 		fli = fs - 1;
-		sli = ffs(pool->sl_bitmaps[fli]) - 1;
+		sli = ffs32(pool->sl_bitmaps[fli]) - 1;
 	}
 	fi = get_freelist_index(fli, sli);
 
@@ -480,9 +1148,49 @@ static uint32_t search_freelists(struct simpl_pool *pool, uint32_t size)
 		"freelists[%d] must exist.", fi);
 	assert_msg(sli < simplc_bits_per_byte,
 		"sli(%d) must smaller than const(%d)", sli, simplc_bits_per_byte);
-	return fi;
+	return pool->freelists[fi];
+}
+
+/** @brief          Search good-fit chunk from freelists.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Adjusted chunk size which be required.
+ *  @return         Head of the first non-empty freelist after rounded up size, NULL if not found.
+ *  @note
+ *  \p size can't over UINT32_MAX. */
+static struct simpl_chunk *search_good_fit(struct simpl_pool *pool, uint32_t size)
+{
+	uint32_t round, fi;
+
+	fi = roundup_mapping(size, &round);
+	if (!fi || round > pool->available)
+		return NULL;
+	return search_from_class(pool, fi);
 }
 
+/** @brief          Search available chunk from freelists.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Adjusted chunk size which be required.
+ *  @return         Available chunk, NULL if not found.
+ *  @note
+ *  \p size can't over UINT32_MAX. */
+static struct simpl_chunk *search_freelists(struct simpl_pool *pool, uint32_t size)
+{
+	struct simpl_chunk *chunk;
+
+	if (!size || size > pool->available)
+		return NULL;
+	if (pool->flags & simpl_flag_bestfit && (chunk = search_size_class(pool, size)))
+		return chunk;
+	if ((chunk = search_good_fit(pool, size)))
+		return chunk;
+	chunk = pool->wilderness; /* served last */
+	return chunk && get_chunk_size(chunk) >= size? chunk: NULL;
+}
+
+/** chunk boundary disappears, keep compaction cursor on a boundary */
+#define absorb_chunk(pool, absorbed, into) \
+	((pool)->compact == (absorbed)? (void)((pool)->compact = (into)): (void)0)
+
 /** @brief           Merge free neighbor chunk.
  *  @param[in] pool  Pool header.
  *  @param[in] chunk The chunk which need to merge free neighbor.
@@ -502,6 +1210,8 @@ static struct simpl_chunk *merge_free_neighbor_chunk(struct simpl_pool *pool, st
 		
 		chunk_size = get_chunk_size(neighbor) + simplc_chunk_overhead + get_chunk_size(chunk);
 		set_chunk_size(neighbor, chunk_size);
+		absorb_chunk(pool, chunk, neighbor);
+		simpl_trace(merge, pool, chunk_size, get_chunk_payload(neighbor), freelists_mapping(chunk_size));
 		
 		chunk = neighbor;
 	}
@@ -515,10 +1225,23 @@ static struct simpl_chunk *merge_free_neighbor_chunk(struct simpl_pool *pool, st
 		
 		chunk_size = get_chunk_size(chunk) + simplc_chunk_overhead + get_chunk_size(neighbor);
 		set_chunk_size(chunk, chunk_size);
+		absorb_chunk(pool, neighbor, chunk);
+		simpl_trace(merge, pool, chunk_size, get_chunk_payload(chunk), freelists_mapping(chunk_size));
 	}
 	return chunk;
 }
 
+/** @brief           Merge run of free chunks before free chunk, carved by simpl_reserve.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk Free chunk out of freelists, next chunk must used.
+ *  @return          New chunk position, always prev used. */
+static struct simpl_chunk *merge_prev_free_chunks(struct simpl_pool *pool, struct simpl_chunk *chunk)
+{
+	while (is_chunk_prev_free(chunk))
+		chunk = merge_free_neighbor_chunk(pool, chunk);
+	return chunk;
+}
+
 /** @brief               Trim head chunk and push exceed chunk to freelists.
  *  @param[in] pool      Pool header.
  *  @param[in] chunk     The chunk which need to trim.
@@ -541,11 +1264,13 @@ static struct simpl_chunk *trim_chunk_to_use(struct simpl_pool *pool, struct sim
 		set_chunk_size(chunk, trim_size);
 
 		trim = next_phys_chunk(chunk);
-		trim->size = remain - simplc_chunk_overhead;
+		put_chunk_word(trim, remain - simplc_chunk_overhead);
 		next_phys_chunk(trim)->phys_prev = trim;
 
 		set_chunk_used(chunk);
 		set_chunk_free(trim);
+		simpl_trace(split, pool, remain - simplc_chunk_overhead, get_chunk_payload(trim),
+			freelists_mapping(remain - simplc_chunk_overhead));
 		
 		trim = merge_free_neighbor_chunk(pool, trim);
 		push_free_chunk(pool, trim);
@@ -555,35 +1280,17 @@ static struct simpl_chunk *trim_chunk_to_use(struct simpl_pool *pool, struct sim
 	return chunk;
 }
 
-void *simpl_malloc(void *simp, size_t alloc_size)
-{
-	struct simpl_pool *pool;
-	struct simpl_chunk *chunk;
-	uint32_t adj_size, fi;
-
-	if (!simp || !alloc_size)
-		return NULL;
-	pool = (struct simpl_pool *)simp;
-
-	adj_size = adjust_alloc_size(alloc_size, simplc_bytes_per_ptr);
-	if (!(fi = search_freelists(pool, adj_size)))
-		return NULL;
-	chunk = pool->freelists[fi];
-	pop_free_chunk(pool, chunk);
-
-	chunk = trim_chunk_to_use(pool, chunk, adj_size);
-	return get_chunk_payload(chunk);
-}
+/** sample SIMPL element when the profile countdown expires */
+#define profile_alloc(pool, payload, size) do { \
+	if ((pool)->profile && simpl_profile_tick((pool)->profile, size)) \
+		simpl_profile_record((pool)->profile, payload, size); \
+} while (0)
 
-void simpl_free(void *simp, void *simple)
+/** @brief           Free used chunk with immediate coalescing.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The used chunk which need to free. */
+static void free_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk)
 {
-	struct simpl_pool *pool;
-	struct simpl_chunk *chunk;
-
-	if (!simp || !simple)
-		return;
-	pool = (struct simpl_pool *)simp;
-	chunk = get_payload_chunk(simple);
 	set_chunk_free(chunk);
 	next_phys_chunk(chunk)->phys_prev = chunk;
 
@@ -591,38 +1298,355 @@ void simpl_free(void *simp, void *simple)
 	push_free_chunk(pool, chunk);
 }
 
-void *simpl_realloc(void *simp, void *simple, size_t realloc_size)
+#ifdef SIMPL_HARDENED
+#define set_quick_key(chunk, key) ((chunk)->free_prev = (struct simpl_chunk *)(key))
+#else
+#define set_quick_key(chunk, key)
+#endif//SIMPL_HARDENED
+
+/** @brief           Detect chunk which already in quick list.
+ *  @param[in] pool  Pool header.
+ *  @param[in] quick Quick list of chunk size.
+ *  @param[in] chunk The chunk which be freed.
+ *  @return          Non-zero if valid, always valid when not hardened.
+ *  @note            Chunk in quick list keeps pool as key, list is scanned only when key matched. */
+static inline int check_quick_chunk(struct simpl_pool *pool, struct simpl_quick *quick, struct simpl_chunk *chunk)
 {
-	struct simpl_pool *pool;
-	struct simpl_chunk *chunk, *prev, *next;
-	uint32_t chunk_size, adj_size;
-	void* payload;
+#ifdef SIMPL_HARDENED
+	struct simpl_chunk *p;
 
-	if (!simple)
-		return simpl_malloc(simp, realloc_size);
-	if (!simp || !realloc_size)
+	if (chunk->free_prev == (struct simpl_chunk *)pool) {
+		for (p = quick->head; p; p = p->free_next) {
+			if (!check_chunk(p != chunk, pool, chunk, "double free"))
+				return 0;
+		}
+	}
+	set_quick_key(chunk, pool);
+#endif//SIMPL_HARDENED
+	return 1;
+}
+
+/** @brief          Coalesce all chunks of quick list.
+ *  @param[in] pool Pool header.
+ *  @param[in] qi   Quick list index. */
+static void flush_quick_list(struct simpl_pool *pool, uint32_t qi)
+{
+	struct simpl_quick *quick = &pool->quick[qi];
+	struct simpl_chunk *chunk;
+
+	while ((chunk = quick->head)) {
+		quick->head = chunk->free_next;
+		pool->deferred -= get_chunk_size(chunk);
+		free_chunk(pool, chunk);
+	}
+	quick->count = 0;
+}
+
+/** @brief          Coalesce all chunks of quick lists.
+ *  @param[in] pool Pool header.
+ *  @return         Non-zero if any chunk coalesced. */
+static int flush_quick_lists(struct simpl_pool *pool)
+{
+	uint32_t qi;
+
+	if (!pool->deferred)
+		return 0;
+	for (qi = 0; qi < simplc_quick_lists; qi++)
+		flush_quick_list(pool, qi);
+	return 1;
+}
+
+/** @brief          Count used chunk into tag.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The used chunk.
+ *  @param[in] tag   Tag less than SIMPL_TAGS. */
+static inline void tag_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk, unsigned int tag)
+{
+#ifdef simpl_tag_in_header
+	if (pool->tags) {
+		chunk->tag = (uint16_t)tag;
+		pool->tags[tag].usage += get_chunk_size(chunk);
+	}
+#else
+	(void)pool, (void)chunk, (void)tag;
+#endif//simpl_tag_in_header
+}
+
+static inline void untag_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk) {
+	if (pool->tags)
+		pool->tags[get_chunk_tag(chunk)].usage -= get_chunk_size(chunk);
+}
+
+/** @brief          Check growth of tag against budget.
+ *  @param[in] pool Pool header.
+ *  @param[in] tag  Tag less than SIMPL_TAGS.
+ *  @param[in] size Growth in bytes.
+ *  @return         Non-zero if allowed. */
+static inline int tag_budget_allow(struct simpl_pool *pool, unsigned int tag, uint32_t size) {
+	return !pool->tags || !pool->tags[tag].budget ||
+		(uint64_t)pool->tags[tag].usage + size <= pool->tags[tag].budget;
+}
+
+/** @brief          Carve used chunk from the front of the free chunk before tail.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Adjusted chunk size.
+ *  @return         The used chunk, NULL if no such free chunk or too small.
+ *  @note
+ *  Remainder takes the place of carved chunk in its freelist unless size class changes,
+ *  address-ordered pool keeps it as wilderness. */
+static struct simpl_chunk *bump_chunk(struct simpl_pool *pool, uint32_t size)
+{
+	struct simpl_chunk *chunk, *remain, *prev, *next;
+	uint32_t chunk_size, remain_size, fi;
+
+	if (!is_chunk_prev_free(pool->tail) || !size)
 		return NULL;
-	adj_size = adjust_alloc_size(realloc_size, simplc_bytes_per_ptr);
-	if (!adj_size)
+	chunk = prev_phys_chunk(pool->tail);
+	chunk_size = get_chunk_size(chunk);
+	if (chunk_size < size + simplc_chunk_overhead + simplc_chunk_min_size ||
+		!check_chunk(is_chunk_free(chunk), pool, chunk, "corrupted tail"))
+		return NULL;
+	remain_size = chunk_size - size - simplc_chunk_overhead;
+	remain = (struct simpl_chunk *)((uint8_t *)chunk + simplc_chunk_overhead + size);
+	fi = freelists_mapping(chunk_size);
+	prev = chunk->free_prev;
+	next = chunk->free_next;
+	if (chunk == pool->wilderness) {
+		pool->wilderness = remain;
+		pool->available -= size + simplc_chunk_overhead;
+	} else if (freelists_mapping(remain_size) != fi) {
+		pop_free_chunk(pool, chunk);
+		prev = NULL; /* pushed after split */
+	} else {
+		if (!check_chunk(prev? prev->free_next == chunk: pool->freelists[fi] == chunk, pool, chunk, "corrupted free previous") ||
+			!check_chunk(!next || next->free_prev == chunk, pool, chunk, "corrupted free next"))
+			return NULL;
+		if (prev)
+			prev->free_next = remain;
+		else
+			pool->freelists[fi] = remain;
+		if (next)
+			next->free_prev = remain;
+		pool->available -= size + simplc_chunk_overhead;
+	}
+
+	put_chunk_word(chunk, size | (get_chunk_flags(chunk) & chunk_flag_prev_free_mask));
+	put_chunk_word(remain, remain_size | chunk_flag_free_mask); /* prev used */
+	pool->tail->phys_prev = remain;
+	simpl_trace(split, pool, remain_size, get_chunk_payload(remain), freelists_mapping(remain_size));
+	if (remain == pool->wilderness)
+		return chunk;
+	if (freelists_mapping(remain_size) != fi) {
+		push_free_chunk(pool, remain);
+	} else {
+		remain->free_prev = prev;
+		remain->free_next = next;
+	}
+	return chunk;
+}
+
+/** @brief          Allocate used chunk, deferred chunks are flushed and child grows if no fit.
+ *  @param[in] pool Pool header.
+ *  @param[in] size Adjusted chunk size.
+ *  @return         The used chunk, NULL if out of memory. */
+static struct simpl_chunk *malloc_chunk(struct simpl_pool *pool, uint32_t size)
+{
+	struct simpl_chunk *chunk;
+	struct simpl_quick *quick;
+
+	if (pool->quick && size && size <= simplc_quick_max_size) {
+		quick = &pool->quick[get_quick_index(size)];
+		if ((chunk = quick->head)) { /* exact size, no split */
+			quick->head = chunk->free_next;
+			set_quick_key(chunk, NULL);
+			quick->count--;
+			pool->deferred -= size;
+			return chunk;
+		}
+	}
+	if (pool->flags & simpl_flag_bump && !pool->mark && (chunk = bump_chunk(pool, size)))
+		return chunk; /* checkpoint may not own the chunk before tail */
+	if (!(chunk = search_freelists(pool, size))) {
+		if ((!pool->quick || !flush_quick_lists(pool) || !(chunk = search_freelists(pool, size))) &&
+			(!grow_child(pool, size) || !(chunk = search_freelists(pool, size)))) {
+			simpl_trace(fail, pool, size, NULL, freelists_mapping(size));
+			return NULL;
+		}
+	}
+	pop_free_chunk(pool, chunk);
+
+	return trim_chunk_to_use(pool, chunk, size);
+}
+
+/** @brief           Release used chunk, into quick list if coalescing deferred.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The used chunk which already untagged. */
+static void release_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk)
+{
+	struct simpl_quick *quick;
+	uint32_t chunk_size = get_chunk_size(chunk);
+
+	if (pool->quick && chunk_size <= simplc_quick_max_size) { /* defer coalescing */
+		quick = &pool->quick[get_quick_index(chunk_size)];
+		if (!check_quick_chunk(pool, quick, chunk))
+			return;
+		chunk->free_next = quick->head;
+		quick->head = chunk;
+		pool->deferred += chunk_size;
+		if (++quick->count > SIMPL_QUICK_THRESHOLD)
+			flush_quick_list(pool, get_quick_index(chunk_size));
+		return;
+	}
+	free_chunk(pool, chunk);
+}
+
+void *simpl_malloc(void *simp, size_t alloc_size)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	void *payload;
+
+	if (!simp || !alloc_size)
 		return NULL;
 	pool = (struct simpl_pool *)simp;
-	chunk = get_payload_chunk(simple);
-	chunk_size = get_chunk_size(chunk);
+	if (alloc_size >= pool->huge_threshold && (payload = malloc_huge(pool, alloc_size))) {
+		simpl_trace(malloc, pool, alloc_size, payload, simplc_huge_index);
+		profile_alloc(pool, payload, huge_profile_size(alloc_size));
+		return payload;
+	}
 
-	if (adj_size <= chunk_size) { /* allow reduce size */
-		chunk = trim_chunk_to_use(pool, chunk, adj_size);
-		return get_chunk_payload(chunk);
+	chunk = malloc_chunk(pool, adjust_alloc_size(alloc_size, simplc_bytes_per_ptr));
+	if (!chunk)
+		return NULL;
+	tag_chunk(pool, chunk, 0);
+	payload = get_chunk_payload(chunk);
+	simpl_trace(malloc, pool, get_chunk_size(chunk), payload, freelists_mapping(get_chunk_size(chunk)));
+	profile_alloc(pool, payload, get_chunk_size(chunk));
+	return payload;
+}
+
+void *simpl_malloc_tagged(void *simp, size_t alloc_size, unsigned int tag)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	uint32_t adj_size;
+	void *payload;
+
+	if (!simp || !alloc_size || tag >= SIMPL_TAGS)
+		return NULL;
+	pool = (struct simpl_pool *)simp;
+
+	adj_size = adjust_alloc_size(alloc_size, simplc_bytes_per_ptr);
+	if (!tag_budget_allow(pool, tag, adj_size) || !(chunk = malloc_chunk(pool, adj_size)))
+		return NULL;
+	tag_chunk(pool, chunk, tag);
+	payload = get_chunk_payload(chunk);
+	simpl_trace(malloc, pool, get_chunk_size(chunk), payload, freelists_mapping(get_chunk_size(chunk)));
+	profile_alloc(pool, payload, get_chunk_size(chunk));
+	return payload;
+}
+
+void *simpl_malloc_class(void *simp, size_t chunk_size, unsigned int fi)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	void *payload;
+
+	if (!simp || !chunk_size)
+		return NULL;
+	pool = (struct simpl_pool *)simp;
+	if (chunk_size & (simplc_bytes_per_ptr - 1) || chunk_size < simplc_chunk_min_size ||
+		chunk_size > simplc_chunk_max_size || chunk_size >= pool->huge_threshold ||
+		pool->quick || pool->flags & (simpl_flag_bestfit | simpl_flag_bump)) /* not folded, or searched before good-fit */
+		return simpl_malloc(simp, chunk_size);
+
+	if (!fi || chunk_size > pool->available || !(chunk = search_from_class(pool, fi)) ||
+		get_chunk_size(chunk) < chunk_size) { /* wilderness, growth, or wrong class */
+		if (!(chunk = malloc_chunk(pool, (uint32_t)chunk_size)))
+			return NULL;
+	} else {
+		pop_free_chunk(pool, chunk);
+		chunk = trim_chunk_to_use(pool, chunk, (uint32_t)chunk_size);
 	}
+	tag_chunk(pool, chunk, 0);
+	payload = get_chunk_payload(chunk);
+	simpl_trace(malloc, pool, get_chunk_size(chunk), payload, fi);
+	profile_alloc(pool, payload, get_chunk_size(chunk));
+	return payload;
+}
+
+void *simpl_calloc(void *simp, size_t nmemb, size_t size)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	void *payload;
+
+	if (!simp || !nmemb || !size || nmemb > SIZE_MAX / size)
+		return NULL;
+	pool = (struct simpl_pool *)simp;
+	if (nmemb * size >= pool->huge_threshold && (payload = malloc_huge(pool, nmemb * size))) { /* mapped zeroed */
+		simpl_trace(malloc, pool, nmemb * size, payload, simplc_huge_index);
+		profile_alloc(pool, payload, huge_profile_size(nmemb * size));
+		return payload;
+	}
+	if (nmemb * size > simplc_chunk_max_size)
+		return NULL;
+
+	chunk = malloc_chunk(pool, adjust_alloc_size(nmemb * size, simplc_bytes_per_ptr));
+	if (!chunk)
+		return NULL;
+	tag_chunk(pool, chunk, 0);
+	payload = get_chunk_payload(chunk);
+	simpl_bulk_zero(payload, nmemb * size);
+	simpl_trace(malloc, pool, get_chunk_size(chunk), payload, freelists_mapping(get_chunk_size(chunk)));
+	profile_alloc(pool, payload, get_chunk_size(chunk));
+	return payload;
+}
+
+void simpl_free(void *simp, void *simple)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	struct simpl_huge *huge;
+
+	if (!simp || !simple)
+		return;
+	pool = (struct simpl_pool *)simp;
+	chunk = get_payload_chunk(simple);
+	if ((huge = chunk_huge(pool, chunk))) {
+		simpl_trace(free, pool, huge->map_size - simplc_huge_overhead, simple, simplc_huge_index);
+		free_huge(pool, huge);
+		return;
+	}
+	if (!check_used_chunk(pool, chunk))
+		return;
+	if (pool->profile)
+		simpl_profile_erase(pool->profile, simple);
+	untag_chunk(pool, chunk);
+	simpl_trace(free, pool, get_chunk_size(chunk), simple, freelists_mapping(get_chunk_size(chunk)));
+	release_chunk(pool, chunk);
+}
+
+/** @brief           Expand used chunk with free neighbors in place.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The used chunk.
+ *  @param[in] size  Adjusted chunk size, greater than chunk size.
+ *  @return          The expanded chunk, payload moved if expanded with previous,
+ *                   NULL if neighbors not enough. */
+static struct simpl_chunk *expand_chunk(struct simpl_pool *pool, struct simpl_chunk *chunk, uint32_t size)
+{
+	struct simpl_chunk *prev, *next;
+	uint32_t chunk_size = get_chunk_size(chunk);
 
 	next = next_phys_chunk(chunk);
 	if (is_chunk_free(next)) { /* allow expand with next */
 		chunk_size += simplc_chunk_overhead + get_chunk_size(next);
-		if (adj_size <= chunk_size) {
+		if (size <= chunk_size) {
 			pop_free_chunk(pool, next);
 			set_chunk_size(chunk, chunk_size);
+			absorb_chunk(pool, next, chunk);
 
-			chunk = trim_chunk_to_use(pool, chunk, adj_size);
-			return get_chunk_payload(chunk);
+			return trim_chunk_to_use(pool, chunk, size);
 		}
 	}
 	if (is_chunk_prev_free(chunk)) { /* allow expand with prev, must memory move */
@@ -630,23 +1654,89 @@ void *simpl_realloc(void *simp, void *simple, size_t realloc_size)
 		assert_msg(is_chunk_free(prev),
 			"chunk prev_freed then prev chunk must freed.");
 		chunk_size += get_chunk_size(prev) + simplc_chunk_overhead;
-		if (adj_size <= chunk_size) {
+		if (size <= chunk_size) {
 			pop_free_chunk(pool, prev);
-			if (is_chunk_free(next))
+			if (is_chunk_free(next)) {
 				pop_free_chunk(pool, next);
+				absorb_chunk(pool, next, prev);
+			}
 			set_chunk_size(prev, chunk_size);
-			memmove(get_chunk_payload(prev), get_chunk_payload(chunk), get_chunk_size(chunk));
+			absorb_chunk(pool, chunk, prev);
+			latency_path(pool, simpl_latency_realloc_merge);
+			simpl_bulk_copy(get_chunk_payload(prev), get_chunk_payload(chunk), get_chunk_size(chunk));
 
-			chunk = trim_chunk_to_use(pool, prev, adj_size);
-			return get_chunk_payload(chunk);
+			return trim_chunk_to_use(pool, prev, size);
 		}
 	}
+	return NULL;
+}
+
+void *simpl_realloc(void *simp, void *simple, size_t realloc_size)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *expanded;
+	struct simpl_huge *huge;
+	uint32_t chunk_size, adj_size;
+	unsigned int tag;
+	void* payload;
+
+	if (!simple)
+		return simpl_malloc(simp, realloc_size);
+	if (!simp || !realloc_size)
+		return NULL;
+	pool = (struct simpl_pool *)simp;
+	chunk = get_payload_chunk(simple);
+	if ((huge = chunk_huge(pool, chunk))) { /* pages moved, not copied */
+		if (!(payload = realloc_huge(pool, huge, realloc_size)))
+			return NULL;
+		if (pool->profile)
+			simpl_profile_erase(pool->profile, simple);
+		simpl_trace(realloc, pool, realloc_size, payload, simplc_huge_index);
+		profile_alloc(pool, payload, huge_profile_size(realloc_size));
+		return payload;
+	}
+	if (!check_used_chunk(pool, chunk))
+		return NULL;
+	chunk_size = get_chunk_size(chunk);
+	if (realloc_size >= pool->huge_threshold && realloc_size > chunk_size &&
+		(payload = malloc_huge(pool, realloc_size))) { /* last copy, grows by remapping later */
+		latency_path(pool, simpl_latency_realloc_copy);
+		simpl_bulk_copy(payload, simple, chunk_size);
+		if (pool->profile)
+			simpl_profile_erase(pool->profile, simple);
+		untag_chunk(pool, chunk);
+		release_chunk(pool, chunk);
+		simpl_trace(realloc, pool, realloc_size, payload, simplc_huge_index);
+		profile_alloc(pool, payload, huge_profile_size(realloc_size));
+		return payload;
+	}
+	adj_size = adjust_alloc_size(realloc_size, simplc_bytes_per_ptr);
+	if (!adj_size)
+		return NULL;
+	tag = get_chunk_tag(chunk);
+	if (adj_size > chunk_size && !tag_budget_allow(pool, tag, adj_size - chunk_size))
+		return NULL;
+	untag_chunk(pool, chunk);
 
-	payload = simpl_malloc(simp, adj_size);  /* find other chunk, must memory copy */
-	if (payload) { 
-		memcpy(payload, simple, get_chunk_size(chunk));
-		simpl_free(simp, simple);
-	}		
+	if (adj_size <= chunk_size) { /* allow reduce size */
+		chunk = trim_chunk_to_use(pool, chunk, adj_size);
+	} else if ((expanded = expand_chunk(pool, chunk, adj_size))) {
+		chunk = expanded;
+	} else if ((expanded = malloc_chunk(pool, adj_size))) { /* find other chunk, must memory copy */
+		latency_path(pool, simpl_latency_realloc_copy);
+		simpl_bulk_copy(get_chunk_payload(expanded), simple, chunk_size);
+		release_chunk(pool, chunk);
+		chunk = expanded;
+	} else {
+		tag_chunk(pool, chunk, tag);
+		return NULL;
+	}
+	if (pool->profile) /* sample kept if failed, as huge block */
+		simpl_profile_erase(pool->profile, simple);
+	tag_chunk(pool, chunk, tag);
+	payload = get_chunk_payload(chunk);
+	simpl_trace(realloc, pool, get_chunk_size(chunk), payload, freelists_mapping(get_chunk_size(chunk)));
+	profile_alloc(pool, payload, get_chunk_size(chunk));
 	return payload;
 }
 
@@ -655,8 +1745,9 @@ void *simpl_memalign(void *simp, size_t align, size_t alloc_size)
 	struct simpl_pool *pool;
 	struct simpl_chunk *chunk, *aligned_chunk;
 	size_t mask;
-	uint32_t adj_size, chunk_size, fi, size;
+	uint32_t adj_size, chunk_size, size;
 	uint8_t *p, *q;
+	void *payload;
 
 	if (align < simplc_bytes_per_ptr)
 		align = simplc_bytes_per_ptr;
@@ -666,9 +1757,14 @@ void *simpl_memalign(void *simp, size_t align, size_t alloc_size)
 	pool = (struct simpl_pool *)simp;
 
 	adj_size = adjust_alloc_size(alloc_size, align);
-	if (!(fi = search_freelists(pool, adj_size + (uint32_t)align + simplc_chunk_min_size)))
-		return NULL;
-	chunk = pool->freelists[fi];
+	size = adj_size + (uint32_t)align + simplc_chunk_min_size;
+	if (!(chunk = search_freelists(pool, size))) {
+		if ((!pool->quick || !flush_quick_lists(pool) || !(chunk = search_freelists(pool, size))) &&
+			(!grow_child(pool, size) || !(chunk = search_freelists(pool, size)))) {
+			simpl_trace(fail, pool, size, NULL, freelists_mapping(size));
+			return NULL;
+		}
+	}
 	pop_free_chunk(pool, chunk);
 
 	chunk_size = get_chunk_size(chunk);
@@ -689,5 +1785,784 @@ void *simpl_memalign(void *simp, size_t align, size_t alloc_size)
 		set_chunk_size(aligned_chunk, chunk_size - size - simplc_chunk_overhead);
 	}
 	aligned_chunk = trim_chunk_to_use(pool, aligned_chunk, adj_size);
-	return get_chunk_payload(aligned_chunk);
+	tag_chunk(pool, aligned_chunk, 0);
+	payload = get_chunk_payload(aligned_chunk);
+	simpl_trace(memalign, pool, get_chunk_size(aligned_chunk), payload,
+		freelists_mapping(get_chunk_size(aligned_chunk)));
+	profile_alloc(pool, payload, get_chunk_size(aligned_chunk));
+	return payload;
+}
+
+/** bytes before user payload of handle chunk, keeps pointer alignment */
+#define handle_prefix_size (simplc_bytes_per_ptr)
+
+/** @brief          Get handle entry of handle.
+ *  @param[in] pool Pool header.
+ *  @param[in] h    Handle.
+ *  @return         Entry, NULL if handle not allocated. */
+static inline struct simpl_handle_entry *get_handle_entry(struct simpl_pool *pool, simpl_handle h) {
+	struct simpl_handle_entry *entry;
+
+	if (!pool->handles || !h || h > pool->handles->capacity)
+		return NULL;
+	entry = &pool->handles->entry[h - 1];
+	return entry->payload? entry: NULL;
+}
+
+/** @brief           Get handle entry of used chunk.
+ *  @param[in] pool  Pool header.
+ *  @param[in] chunk The used chunk.
+ *  @return          Entry, NULL if chunk not allocated by simpl_halloc.
+ *  @note            Index of payload prefix is trusted only if its entry points back. */
+static inline struct simpl_handle_entry *chunk_handle_entry(struct simpl_pool *pool, struct simpl_chunk *chunk) {
+	uintptr_t index = *(uintptr_t *)get_chunk_payload(chunk);
+
+	if (index >= pool->handles->capacity || pool->handles->entry[index].payload != get_chunk_payload(chunk))
+		return NULL;
+	return &pool->handles->entry[index];
+}
+
+/** @brief          Grow handle table by doubling.
+ *  @param[in] pool Pool header.
+ *  @return         Non-zero if succeed. */
+static int grow_handles(struct simpl_pool *pool)
+{
+	struct simpl_handles *handles, *old = pool->handles;
+	struct simpl_chunk *chunk;
+	uint32_t i, capacity = old? old->capacity * 2: 64;
+
+	chunk = malloc_chunk(pool, adjust_alloc_size(offsetof(struct simpl_handles, entry) +
+		capacity * sizeof(struct simpl_handle_entry), simplc_bytes_per_ptr));
+	if (!chunk)
+		return 0;
+	handles = (struct simpl_handles *)get_chunk_payload(chunk);
+	i = 0;
+	if (old) {
+		memcpy(handles->entry, old->entry, old->capacity * sizeof(struct simpl_handle_entry));
+		i = old->capacity;
+		release_chunk(pool, get_payload_chunk(old));
+	}
+	handles->capacity = capacity;
+	handles->unused = i + 1;
+	for (; i < capacity; i++) {
+		handles->entry[i].payload = NULL;
+		handles->entry[i].locks = 0;
+		handles->entry[i].next = i + 1 < capacity? i + 2: 0;
+	}
+	pool->handles = handles;
+	return 1;
+}
+
+/** @brief          Drop handles of released region, or table itself.
+ *  @param[in] pool Pool header.
+ *  @param[in] begin Region begin.
+ *  @param[in] end   Region end. */
+static void forget_handles(struct simpl_pool *pool, struct simpl_chunk *begin, struct simpl_chunk *end)
+{
+	struct simpl_handles *handles = pool->handles;
+	struct simpl_handle_entry *entry;
+	uint32_t i;
+
+	if ((uint8_t *)handles >= (uint8_t *)begin && (uint8_t *)handles < (uint8_t *)end) {
+		pool->handles = NULL;
+		return;
+	}
+	for (i = 0; i < handles->capacity; i++) {
+		entry = &handles->entry[i];
+		if ((uint8_t *)entry->payload >= (uint8_t *)begin && (uint8_t *)entry->payload < (uint8_t *)end) {
+			entry->payload = NULL;
+			entry->locks = 0;
+			entry->next = handles->unused;
+			handles->unused = i + 1;
+		}
+	}
+}
+
+simpl_handle simpl_halloc(void *simp, size_t alloc_size)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	struct simpl_handle_entry *entry;
+	uint32_t index;
+
+	if (!simp || !alloc_size || alloc_size > simplc_chunk_max_size - handle_prefix_size)
+		return 0;
+	pool = (struct simpl_pool *)simp;
+	if (!(pool->handles && pool->handles->unused) && !grow_handles(pool))
+		return 0;
+	chunk = malloc_chunk(pool, adjust_alloc_size(alloc_size + handle_prefix_size, simplc_bytes_per_ptr));
+	if (!chunk)
+		return 0;
+	tag_chunk(pool, chunk, 0);
+
+	index = pool->handles->unused - 1;
+	entry = &pool->handles->entry[index];
+	pool->handles->unused = entry->next;
+	entry->payload = get_chunk_payload(chunk);
+	entry->locks = 0;
+	*(uintptr_t *)entry->payload = index;
+	return index + 1;
+}
+
+void *simpl_hlock(void *simp, simpl_handle handle)
+{
+	struct simpl_handle_entry *entry;
+
+	if (!simp || !(entry = get_handle_entry((struct simpl_pool *)simp, handle)))
+		return NULL;
+	entry->locks++;
+	return (uint8_t *)entry->payload + handle_prefix_size;
+}
+
+void simpl_hunlock(void *simp, simpl_handle handle)
+{
+	struct simpl_handle_entry *entry;
+
+	if (!simp || !(entry = get_handle_entry((struct simpl_pool *)simp, handle)))
+		return;
+	assert_msg(entry->locks, "handle(%u) not locked.", (unsigned)handle);
+	if (entry->locks)
+		entry->locks--;
+}
+
+void simpl_hfree(void *simp, simpl_handle handle)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+	struct simpl_handle_entry *entry;
+
+	if (!simp)
+		return;
+	pool = (struct simpl_pool *)simp;
+	if (!(entry = get_handle_entry(pool, handle)))
+		return;
+	chunk = get_payload_chunk(entry->payload);
+	if (!check_used_chunk(pool, chunk))
+		return;
+	entry->payload = NULL;
+	entry->locks = 0;
+	entry->next = pool->handles->unused;
+	pool->handles->unused = (uint32_t)handle;
+	untag_chunk(pool, chunk);
+	release_chunk(pool, chunk);
+}
+
+/** @brief           Slide used chunk down into free chunk before it.
+ *  @param[in] pool  Pool header.
+ *  @param[in] hole  The free chunk.
+ *  @param[in] chunk The used chunk after \p hole.
+ *  @return          The slid chunk at address of \p hole, followed by merged free chunk. */
+static struct simpl_chunk *slide_chunk(struct simpl_pool *pool, struct simpl_chunk *hole, struct simpl_chunk *chunk)
+{
+	uint32_t hole_size, size = get_chunk_size(chunk);
+	struct simpl_chunk *rest;
+#ifdef simpl_tag_in_header
+	uint16_t tag = chunk->tag;
+#endif//simpl_tag_in_header
+
+	pop_free_chunk(pool, hole);
+	hole = merge_prev_free_chunks(pool, hole); /* free neighbors of simpl_reserve */
+	hole_size = get_chunk_size(hole);
+	simpl_bulk_copy(get_chunk_payload(hole), get_chunk_payload(chunk), size); /* header of chunk may be overwritten */
+	put_chunk_word(hole, size);
+#ifdef simpl_tag_in_header
+	hole->tag = tag;
+#endif//simpl_tag_in_header
+
+	rest = next_phys_chunk(hole);
+	put_chunk_word(rest, hole_size);
+	free_chunk(pool, rest);
+	return hole;
+}
+
+size_t simpl_compact(void *simp, size_t budget)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *next;
+	struct simpl_handle_entry *entry;
+	size_t moved = 0, cost;
+
+	if (!simp)
+		return 0;
+	pool = (struct simpl_pool *)simp;
+	if (!pool->handles || pool->mark) /* elements before checkpoint must stay */
+		return 0;
+	if (pool->quick)
+		flush_quick_lists(pool);
+
+	chunk = pool->compact? pool->compact: pool->first;
+	while (budget && chunk != pool->tail) {
+		next = next_phys_chunk(chunk);
+		cost = sizeof(struct simpl_chunk);
+		if (is_chunk_free(chunk) && next != pool->tail && !is_chunk_free(next) &&
+			(entry = chunk_handle_entry(pool, next)) && !entry->locks) {
+			chunk = slide_chunk(pool, chunk, next);
+			entry->payload = get_chunk_payload(chunk);
+			cost += get_chunk_size(chunk);
+			moved += get_chunk_size(chunk);
+		}
+		budget -= cost < budget? cost: budget;
+		chunk = next_phys_chunk(chunk);
+	}
+	pool->compact = chunk == pool->tail? NULL: chunk; /* restart after full pass */
+	return moved;
+}
+
+size_t simpl_trim(void *simp, size_t *new_size)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *tail;
+	size_t trimmed = 0;
+
+	if (!simp)
+		return 0;
+	pool = (struct simpl_pool *)simp;
+	tail = pool->tail;
+	if (!pool->mark) { /* checkpoint keeps its end chunk */
+		if (pool->quick)
+			flush_quick_lists(pool);
+		if (is_chunk_prev_free(tail)) {
+			chunk = prev_phys_chunk(tail);
+			pop_free_chunk(pool, chunk);
+			chunk = merge_prev_free_chunks(pool, chunk); /* free neighbors of simpl_reserve */
+			if (pool->compact == chunk)
+				pool->compact = NULL;
+			if (chunk == pool->first) { /* keep minimal first chunk for reset */
+				set_chunk_size(chunk, simplc_chunk_min_size);
+				tail = next_phys_chunk(chunk);
+				put_chunk_word(tail, chunk_flag_prev_free_mask);
+				tail->phys_prev = chunk;
+				push_free_chunk(pool, chunk);
+			} else { /* previous chunk is used after coalescing */
+				tail = chunk;
+				put_chunk_word(tail, 0);
+			}
+			trimmed = (size_t)((uint8_t *)pool->tail - (uint8_t *)tail);
+			pool->tail = tail;
+		}
+	}
+	if (new_size)
+		*new_size = (size_t)((uint8_t *)tail + simplc_chunk_overlap_size + simplc_chunk_overhead - (uint8_t *)pool);
+	return trimmed;
+}
+
+void *simpl_child_create(void *parent, size_t size)
+{
+	struct simpl_pool *pool;
+	void *buffer;
+
+	if (!parent || ((struct simpl_pool *)parent)->mark) /* child header would be released by checkpoint */
+		return NULL;
+	if (!(buffer = simpl_malloc(parent, size)))
+		return NULL;
+	if (!(pool = (struct simpl_pool *)simpl_init_ex(buffer, size, ((struct simpl_pool *)parent)->flags))) {
+		simpl_free(parent, buffer);
+		return NULL;
+	}
+	assert_msg((void *)pool == buffer, "child(%p) must start SIMPL element.", (void *)pool);
+	pool->parent = (struct simpl_pool *)parent;
+	pool->sibling = pool->parent->children;
+	pool->parent->children = pool;
+	pool->region_size = sizeof(struct simpl_region) + (size_t)((uint8_t *)pool->tail - (uint8_t *)pool->first) +
+		simplc_chunk_overhead;
+	return pool;
+}
+
+void simpl_child_destroy(void *child)
+{
+	struct simpl_pool *pool, **link;
+	struct simpl_region *region;
+
+	if (!child || !((struct simpl_pool *)child)->parent)
+		return;
+	pool = (struct simpl_pool *)child;
+	for (link = &pool->parent->children; *link; link = &(*link)->sibling) {
+		if (*link == pool) {
+			*link = pool->sibling;
+			break;
+		}
+	}
+	while (pool->huge)
+		free_huge(pool, pool->huge);
+	while ((region = pool->regions)) {
+		pool->regions = region->next;
+		simpl_free(pool->parent, region);
+	}
+	simpl_free(pool->parent, pool);
+}
+
+/** @brief          Check if pointer is inside buffer or regions of pool.
+ *  @param[in] pool Pool header.
+ *  @param[in] ptr  Any pointer.
+ *  @return         Non-zero if inside. */
+static int pool_contains(struct simpl_pool *pool, const void *ptr)
+{
+	struct simpl_region *region;
+
+	if ((const uint8_t *)ptr >= (uint8_t *)pool && (const uint8_t *)ptr < (uint8_t *)pool->tail)
+		return 1;
+	for (region = pool->regions; region; region = region->next) {
+		if ((const uint8_t *)ptr >= (uint8_t *)region && (const uint8_t *)ptr < (uint8_t *)region->end)
+			return 1;
+	}
+	return 0;
+}
+
+void *simpl_owner_of(void *simp, const void *ptr)
+{
+	struct simpl_pool *pool = (struct simpl_pool *)simp, *child;
+
+	while (pool) {
+		for (child = pool->children; child && !pool_contains(child, ptr); child = child->sibling)
+			continue;
+		if (!child)
+			break;
+		pool = child;
+	}
+	return pool;
+}
+
+/** @brief          Get the largest free chunk.
+ *  @param[in] pool Pool header.
+ *  @return         Head of the highest non-empty freelist, NULL if none. */
+static struct simpl_chunk *largest_free_chunk(struct simpl_pool *pool)
+{
+	struct simpl_chunk *chunk;
+	uint32_t fli, sli;
+
+	if (!pool->fl_bitmap)
+		return pool->wilderness;
+	fli = fls32(pool->fl_bitmap) - 1;
+	sli = fls32(pool->sl_bitmaps[fli]) - 1;
+	chunk = pool->freelists[get_freelist_index(fli, sli)];
+	if (pool->wilderness && get_chunk_size(pool->wilderness) > get_chunk_size(chunk))
+		return pool->wilderness;
+	return chunk;
+}
+
+size_t simpl_reserve(void *simp, size_t size, size_t count, int prefault)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *carve, *next;
+	uint32_t adj_size, round, stride;
+	size_t fits, remain, i;
+	volatile uint8_t *page;
+
+	if (!simp || !size || !count)
+		return 0;
+	pool = (struct simpl_pool *)simp;
+	if (!(adj_size = adjust_alloc_size(size, simplc_bytes_per_ptr)) || !roundup_mapping(adj_size, &round))
+		return 0;
+	if (pool->quick)
+		flush_quick_lists(pool);
+	if (!(chunk = largest_free_chunk(pool)))
+		return 0;
+	stride = round + simplc_chunk_overhead; /* lower bound of class, found by good-fit without split */
+	fits = ((size_t)get_chunk_size(chunk) + simplc_chunk_overhead) / stride;
+	fits = fits < count? fits: count;
+	remain = (size_t)get_chunk_size(chunk) + simplc_chunk_overhead - fits * stride;
+	if (remain && remain < simplc_chunk_overhead + simplc_chunk_min_size) {
+		fits--;
+		remain += stride;
+	}
+	if (!fits)
+		return 0;
+	pop_free_chunk(pool, chunk);
+	next = next_phys_chunk(chunk);
+	for (page = (uint8_t *)get_chunk_payload(chunk); prefault && page < (uint8_t *)next; page += simplc_4kB_size)
+		*page = *page; /* fault in writable, links are written after */
+
+	if (remain) { /* remainder keeps its place before next */
+		carve = (struct simpl_chunk *)((uint8_t *)chunk + fits * stride);
+		put_chunk_word(carve, (uint32_t)(remain - simplc_chunk_overhead) | chunk_flags_mask);
+		carve->phys_prev = (struct simpl_chunk *)((uint8_t *)carve - stride);
+		next->phys_prev = carve;
+		push_free_chunk(pool, carve);
+	} else {
+		next->phys_prev = (struct simpl_chunk *)((uint8_t *)chunk + (fits - 1) * stride);
+	}
+	for (i = fits - 1; i; i--) { /* pushed from the end, lowest address served first */
+		carve = (struct simpl_chunk *)((uint8_t *)chunk + i * stride);
+		put_chunk_word(carve, round | chunk_flags_mask);
+		carve->phys_prev = (struct simpl_chunk *)((uint8_t *)carve - stride);
+		push_free_chunk(pool, carve);
+	}
+	set_chunk_size(chunk, round);
+	push_free_chunk(pool, chunk);
+	return fits;
+}
+
+void *simpl_mark(void *simp)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *end;
+	struct simpl_mark *mark;
+	uint32_t fl_bitmap, sl_bitmap, mark_size, heads = 0;
+	int fli, sli;
+
+	if (!simp)
+		return NULL;
+	pool = (struct simpl_pool *)simp;
+	if (pool->quick)
+		flush_quick_lists(pool);
+	if (!(chunk = largest_free_chunk(pool)))
+		return NULL;
+	for (fl_bitmap = pool->fl_bitmap; (fli = ffs32(fl_bitmap)); fl_bitmap &= fl_bitmap - 1)
+		for (sl_bitmap = pool->sl_bitmaps[fli - 1]; sl_bitmap; sl_bitmap &= sl_bitmap - 1)
+			heads++;
+	mark_size = (uint32_t)align_up(offsetof(struct simpl_mark, heads) + heads * sizeof(struct simpl_chunk *) +
+		(pool->tags? SIMPL_TAGS * sizeof(uint32_t): 0), simplc_bytes_per_ptr);
+	if (get_chunk_size(chunk) < mark_size + simplc_chunk_overhead + simplc_chunk_min_size)
+		return NULL;
+	pop_free_chunk(pool, chunk);
+	end = next_phys_chunk(chunk);
+
+	mark = (struct simpl_mark *)get_chunk_payload(chunk); /* save pool state without the region */
+	mark->prev = pool->mark;
+	mark->end = end;
+	mark->wilderness = pool->wilderness;
+	mark->huge = pool->huge;
+	mark->available = pool->available;
+	mark->fl_bitmap = pool->fl_bitmap;
+	memcpy(mark->sl_bitmaps, pool->sl_bitmaps, fls32(pool->fl_bitmap));
+	heads = 0;
+	for (fl_bitmap = pool->fl_bitmap; (fli = ffs32(fl_bitmap)); fl_bitmap &= fl_bitmap - 1)
+		for (sl_bitmap = pool->sl_bitmaps[fli - 1]; (sli = ffs32(sl_bitmap)); sl_bitmap &= sl_bitmap - 1)
+			mark->heads[heads++] = pool->freelists[get_freelist_index(fli - 1, sli - 1)];
+	for (fli = 0; pool->tags && fli < SIMPL_TAGS; fli++)
+		((uint32_t *)&mark->heads[heads])[fli] = pool->tags[fli].usage;
+	clear_freelists(pool);
+
+	chunk = trim_chunk_to_use(pool, chunk, mark_size);
+	pool->mark = mark;
+	return mark;
+}
+
+void simpl_release_to_mark(void *simp, void *mark)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk, *end;
+	struct simpl_mark *m = (struct simpl_mark *)mark;
+	uint32_t fl_bitmap, sl_bitmap, heads = 0;
+	int fli, sli;
+
+	if (!simp || !mark)
+		return;
+	pool = (struct simpl_pool *)simp;
+	for (m = pool->mark; m && m != mark; m = m->prev);
+	assert_msg(m, "mark(%p) not found.", mark);
+	if (!m)
+		return;
+
+	clear_freelists(pool);
+	if (pool->quick) /* quick lists only hold chunks of region */
+		memset(pool->quick, 0, simplc_quick_lists * sizeof(struct simpl_quick));
+	pool->deferred = 0;
+	pool->wilderness = m->wilderness;
+	pool->available = m->available;
+	pool->fl_bitmap = m->fl_bitmap;
+	memcpy(pool->sl_bitmaps, m->sl_bitmaps, fls32(m->fl_bitmap));
+	for (fl_bitmap = m->fl_bitmap; (fli = ffs32(fl_bitmap)); fl_bitmap &= fl_bitmap - 1)
+		for (sl_bitmap = m->sl_bitmaps[fli - 1]; (sli = ffs32(sl_bitmap)); sl_bitmap &= sl_bitmap - 1)
+			pool->freelists[get_freelist_index(fli - 1, sli - 1)] = m->heads[heads++];
+	for (fli = 0; pool->tags && fli < SIMPL_TAGS; fli++) /* elements before mark can't be freed */
+		pool->tags[fli].usage = ((uint32_t *)&m->heads[heads])[fli];
+	pool->mark = m->prev;
+	while (pool->huge != m->huge) /* huge blocks of region */
+		free_huge(pool, pool->huge);
+
+	chunk = get_payload_chunk(m); /* whole region back to one free chunk */
+	end = m->end;
+	pool->compact = NULL;
+	if (pool->handles)
+		forget_handles(pool, chunk, end);
+	if (pool->profile) { /* drop samples of region, or profile itself */
+		if ((uint8_t *)pool->profile >= (uint8_t *)chunk && (uint8_t *)pool->profile < (uint8_t *)end)
+			pool->profile = NULL;
+		else
+			simpl_profile_erase_range(pool->profile, chunk, end);
+	}
+	set_chunk_size(chunk, (uint32_t)((uint8_t *)end - (uint8_t *)chunk) - simplc_chunk_overhead);
+	set_chunk_free(chunk);
+	end->phys_prev = chunk;
+
+	chunk = merge_free_neighbor_chunk(pool, chunk);
+	push_free_chunk(pool, chunk);
+}
+
+void simpl_get_stats(void *simp, struct simpl_stats *stats)
+{
+	struct simpl_pool *pool;
+	struct simpl_chunk *chunk;
+
+	if (!simp || !stats)
+		return;
+	pool = (struct simpl_pool *)simp;
+	chunk = largest_free_chunk(pool);
+	stats->available = pool->available;
+	stats->deferred = pool->deferred;
+	stats->largest_free = chunk? get_chunk_size(chunk): 0;
+	stats->huge = pool->huge_bytes;
+}
+
+void simpl_set_huge_threshold(void *simp, size_t threshold)
+{
+	if (simp)
+		((struct simpl_pool *)simp)->huge_threshold = threshold? threshold: SIZE_MAX;
+}
+
+int simpl_snapshot(void *simp, int fd)
+{
+	struct simpl_pool *pool;
+	struct simpl_snapshot_header header;
+	struct simpl_snapshot_chunk records[64];
+	struct simpl_chunk *chunk;
+	uint32_t lengths[simplc_max_freelists], fl_bitmap, sl_bitmap, fi, n = 0;
+	int fli, sli, ret;
+
+	if (!simp || fd < 0)
+		return -EINVAL;
+	pool = (struct simpl_pool *)simp;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SIMPL_SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = SIMPL_SNAPSHOT_VERSION;
+	header.header_size = sizeof(header);
+	header.flags = pool->flags;
+	header.bytes_per_ptr = simplc_bytes_per_ptr;
+	header.chunk_overhead = simplc_chunk_overhead;
+	header.chunk_min_size = simplc_chunk_min_size;
+	header.base = (uintptr_t)pool->first;
+	header.pool_size = (uint32_t)((uint8_t *)pool->tail - (uint8_t *)pool->first);
+	header.available = pool->available;
+	header.deferred = pool->deferred;
+	header.fl_bitmap = pool->fl_bitmap;
+	memcpy(header.sl_bitmaps, pool->sl_bitmaps, fls32(pool->fl_bitmap));
+	header.freelists = simplc_max_freelists;
+	header.quick_lists = pool->quick? simplc_quick_lists: 0;
+	for (chunk = pool->first; chunk != pool->tail; chunk = next_phys_chunk(chunk))
+		header.chunks++;
+	if ((ret = simpl_snapshot_write(fd, &header, sizeof(header))))
+		return ret;
+
+	memset(lengths, 0, sizeof(lengths)); /* only lists of set bitmaps are walked */
+	for (fl_bitmap = pool->fl_bitmap; (fli = ffs32(fl_bitmap)); fl_bitmap &= fl_bitmap - 1) {
+		for (sl_bitmap = pool->sl_bitmaps[fli - 1]; (sli = ffs32(sl_bitmap)); sl_bitmap &= sl_bitmap - 1) {
+			fi = get_freelist_index(fli - 1, sli - 1);
+			for (chunk = pool->freelists[fi]; chunk; chunk = chunk->free_next)
+				lengths[fi]++;
+		}
+	}
+	if ((ret = simpl_snapshot_write(fd, lengths, sizeof(lengths))))
+		return ret;
+	for (fi = 0; fi < header.quick_lists; fi++) {
+		if ((ret = simpl_snapshot_write(fd, &pool->quick[fi].count, sizeof(uint32_t))))
+			return ret;
+	}
+
+	for (chunk = pool->first; chunk != pool->tail; chunk = next_phys_chunk(chunk)) {
+		records[n].offset = (uint32_t)((uint8_t *)chunk - (uint8_t *)pool->first);
+		records[n].size = get_chunk_size(chunk);
+		records[n].flags = (uint16_t)(get_chunk_flags(chunk) |
+			(chunk == pool->wilderness? simpl_snapshot_chunk_wilderness: 0));
+		records[n].tag = (uint16_t)(pool->tags && !is_chunk_free(chunk)? get_chunk_tag(chunk): 0);
+		if (++n == sizeof(records) / sizeof(records[0])) {
+			if ((ret = simpl_snapshot_write(fd, records, sizeof(records))))
+				return ret;
+			n = 0;
+		}
+	}
+	return n? simpl_snapshot_write(fd, records, n * sizeof(records[0])): 0;
+}
+
+size_t simpl_tag_usage(void *simp, unsigned int tag)
+{
+	struct simpl_pool *pool = (struct simpl_pool *)simp;
+
+	if (!pool || !pool->tags || tag >= SIMPL_TAGS)
+		return 0;
+	return pool->tags[tag].usage;
+}
+
+void simpl_set_tag_budget(void *simp, unsigned int tag, size_t budget)
+{
+	struct simpl_pool *pool = (struct simpl_pool *)simp;
+
+	if (!pool || !pool->tags || tag >= SIMPL_TAGS)
+		return;
+	pool->tags[tag].budget = budget > simplc_chunk_max_size? simplc_chunk_max_size: (uint32_t)budget;
+}
+
+int simpl_profile_start(void *simp, size_t sample_period, size_t max_samples)
+{
+	struct simpl_pool *pool;
+
+	if (!simp || !sample_period || !max_samples)
+		return -EINVAL;
+	pool = (struct simpl_pool *)simp;
+	if (pool->profile)
+		return -EBUSY;
+	pool->profile = simpl_profile_create(simp, sample_period, max_samples);
+	return pool->profile? 0: -ENOMEM;
+}
+
+void simpl_profile_stop(void *simp)
+{
+	struct simpl_pool *pool;
+	struct simpl_profile *profile;
+
+	if (!simp)
+		return;
+	pool = (struct simpl_pool *)simp;
+	profile = pool->profile;
+	pool->profile = NULL;
+	simpl_free(simp, profile);
+}
+
+int simpl_profile_dump(void *simp, int fd)
+{
+	struct simpl_pool *pool;
+
+	if (!simp || fd < 0)
+		return -EINVAL;
+	pool = (struct simpl_pool *)simp;
+	if (!pool->profile)
+		return -EINVAL;
+	return simpl_profile_write(pool->profile, fd);
+}
+
+#ifdef SIMPL_LATENCY
+#undef simpl_malloc
+#undef simpl_free
+#undef simpl_realloc
+#undef simpl_memalign
+#undef simpl_calloc
+#undef simpl_malloc_tagged
+#undef simpl_malloc_class
+
+/** @brief           Bucket of ticks, 8 linear buckets then 4 per power of two.
+ *  @param[in] ticks Latency.
+ *  @return          Bucket index, the last one is unbounded. */
+static inline uint32_t latency_bucket(uint64_t ticks)
+{
+	uint32_t e, bucket;
+
+	if (ticks < 8)
+		return (uint32_t)ticks;
+	for (e = 3; e < 63 && (ticks >> (e + 1)); e++);
+	bucket = 8 + (e - 3) * 4 + (uint32_t)((ticks >> (e - 2)) & 3);
+	return bucket < SIMPL_LATENCY_BUCKETS? bucket: SIMPL_LATENCY_BUCKETS - 1;
+}
+
+static inline void record_latency(struct simpl_pool *pool, uint32_t op, uint64_t ticks)
+{
+	struct simpl_latency_histogram *histogram = &pool->latency->histograms[op];
+
+	histogram->count++;
+	histogram->max = ticks > histogram->max? ticks: histogram->max;
+	histogram->buckets[latency_bucket(ticks)]++;
+}
+
+void *simpl_malloc(void *simp, size_t alloc_size)
+{
+	uint64_t t = simpl_latency_now();
+	void *payload = untimed_malloc(simp, alloc_size);
+
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_malloc, simpl_latency_now() - t);
+	return payload;
+}
+
+void simpl_free(void *simp, void *simple)
+{
+	uint64_t t = simpl_latency_now();
+
+	untimed_free(simp, simple);
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_free, simpl_latency_now() - t);
+}
+
+void *simpl_realloc(void *simp, void *simple, size_t realloc_size)
+{
+	struct simpl_pool *pool = (struct simpl_pool *)simp;
+	uint64_t t;
+	void *payload;
+
+	if (pool && pool->latency)
+		pool->latency->path = simpl_latency_realloc;
+	t = simpl_latency_now();
+	payload = untimed_realloc(simp, simple, realloc_size);
+	t = simpl_latency_now() - t;
+	if (pool && pool->latency) {
+		record_latency(pool, simpl_latency_realloc, t);
+		if (pool->latency->path != simpl_latency_realloc)
+			record_latency(pool, pool->latency->path, t);
+	}
+	return payload;
+}
+
+void *simpl_memalign(void *simp, size_t align, size_t alloc_size)
+{
+	uint64_t t = simpl_latency_now();
+	void *payload = untimed_memalign(simp, align, alloc_size);
+
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_memalign, simpl_latency_now() - t);
+	return payload;
+}
+
+void *simpl_calloc(void *simp, size_t nmemb, size_t size)
+{
+	uint64_t t = simpl_latency_now();
+	void *payload = untimed_calloc(simp, nmemb, size);
+
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_malloc, simpl_latency_now() - t);
+	return payload;
+}
+
+void *simpl_malloc_tagged(void *simp, size_t alloc_size, unsigned int tag)
+{
+	uint64_t t = simpl_latency_now();
+	void *payload = untimed_malloc_tagged(simp, alloc_size, tag);
+
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_malloc, simpl_latency_now() - t);
+	return payload;
+}
+
+void *simpl_malloc_class(void *simp, size_t chunk_size, unsigned int fi)
+{
+	uint64_t t = simpl_latency_now();
+	void *payload = untimed_malloc_class(simp, chunk_size, fi);
+
+	if (simp && ((struct simpl_pool *)simp)->latency)
+		record_latency((struct simpl_pool *)simp, simpl_latency_malloc, simpl_latency_now() - t);
+	return payload;
+}
+#endif//SIMPL_LATENCY
+
+int simpl_get_latency_histograms(void *simp, struct simpl_latency_histogram *histograms, unsigned int ops)
+{
+	if (!simp || !histograms)
+		return -EINVAL;
+#ifdef SIMPL_LATENCY
+	if (!((struct simpl_pool *)simp)->latency)
+		return -ENOSPC;
+	if (ops > simpl_latency_ops)
+		ops = simpl_latency_ops;
+	memcpy(histograms, ((struct simpl_pool *)simp)->latency->histograms, ops * sizeof(struct simpl_latency_histogram));
+	return (int)ops;
+#else
+	(void)ops;
+	return -ENOTSUP;
+#endif//SIMPL_LATENCY
+}
+
+uint64_t simpl_latency_bucket_limit(unsigned int bucket)
+{
+	if (bucket < 8)
+		return bucket + 1;
+	if (bucket >= SIMPL_LATENCY_BUCKETS - 1)
+		return UINT64_MAX;
+	return (uint64_t)(4 + (bucket - 8) % 4 + 1) << ((bucket - 8) / 4 + 1);
 }
@@ -0,0 +1,234 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-analyze.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "src/simpl-snapshot.h"
+
+#define map_columns (64)
+#define map_rows    (16)
+
+struct snapshot {
+	struct simpl_snapshot_header header;
+	uint32_t *lengths;
+	uint32_t *quick_lengths;
+	struct simpl_snapshot_chunk *chunks;
+};
+
+static int read_snapshot(FILE *file, struct snapshot *s)
+{
+	memset(s, 0, sizeof(struct snapshot));
+	if (fread(&s->header, sizeof(s->header), 1, file) != 1 ||
+		memcmp(s->header.magic, SIMPL_SNAPSHOT_MAGIC, sizeof(s->header.magic)) ||
+		s->header.version != SIMPL_SNAPSHOT_VERSION || s->header.header_size != sizeof(s->header))
+		return -1;
+	s->lengths = (uint32_t *)calloc(s->header.freelists + 1, sizeof(uint32_t));
+	s->quick_lengths = (uint32_t *)calloc(s->header.quick_lists + 1, sizeof(uint32_t));
+	s->chunks = (struct simpl_snapshot_chunk *)calloc(s->header.chunks + 1, sizeof(struct simpl_snapshot_chunk));
+	if (!s->lengths || !s->quick_lengths || !s->chunks ||
+		fread(s->lengths, sizeof(uint32_t), s->header.freelists, file) != s->header.freelists ||
+		fread(s->quick_lengths, sizeof(uint32_t), s->header.quick_lists, file) != s->header.quick_lists ||
+		fread(s->chunks, sizeof(struct simpl_snapshot_chunk), s->header.chunks, file) != s->header.chunks)
+		return -1;
+	return 0;
+}
+
+static void free_snapshot(struct snapshot *s)
+{
+	free(s->lengths);
+	free(s->quick_lengths);
+	free(s->chunks);
+}
+
+/** @brief          Largest memalign size which fits free chunk.
+ *  @param[in] s     Snapshot.
+ *  @param[in] c     Free chunk.
+ *  @param[in] align Alignment.
+ *  @return          Bytes, multiple of align. */
+static uint64_t aligned_fit(const struct snapshot *s, const struct simpl_snapshot_chunk *c, uint64_t align)
+{
+	uint64_t payload = s->header.base + c->offset + s->header.bytes_per_ptr + s->header.chunk_overhead;
+	uint64_t end = payload + c->size, q = payload;
+
+	if (payload & (align - 1)) /* leading free chunk split off, as simpl_memalign */
+		q = (payload + s->header.chunk_min_size + s->header.chunk_overhead + align - 1) & ~(align - 1);
+	return q < end? (end - q) & ~(align - 1): 0;
+}
+
+static void report_summary(const struct snapshot *s)
+{
+	uint32_t i, used = 0, freed = 0, largest = 0;
+	uint64_t free_bytes = 0, used_bytes = 0;
+
+	for (i = 0; i < s->header.chunks; i++) {
+		if (s->chunks[i].flags & simpl_snapshot_chunk_free) {
+			freed++;
+			free_bytes += s->chunks[i].size;
+			largest = s->chunks[i].size > largest? s->chunks[i].size: largest;
+		} else {
+			used++;
+			used_bytes += s->chunks[i].size;
+		}
+	}
+	printf("  pool       %10u bytes  %u chunks (%u used, %u free)  flags 0x%x  %u-bit\n",
+		s->header.pool_size, s->header.chunks, used, freed, s->header.flags, s->header.bytes_per_ptr * 8);
+	printf("  available  %10u bytes  deferred %u bytes  used %llu bytes\n",
+		s->header.available, s->header.deferred, (unsigned long long)used_bytes);
+	printf("[Fragmentation]\n");
+	printf("  largest free chunk   %10u bytes\n", largest);
+	printf("  average free chunk   %10.1f bytes\n", freed? (double)free_bytes / freed: 0.0);
+	printf("  external (1 - largest / free)      %.4f\n", free_bytes? 1.0 - (double)largest / free_bytes: 0.0);
+	printf("  overhead (headers / pool)          %.4f\n",
+		s->header.pool_size? (double)s->header.chunks * s->header.chunk_overhead / s->header.pool_size: 0.0);
+}
+
+static void report_histogram(const struct snapshot *s)
+{
+	uint64_t bytes[33] = {0};
+	uint32_t counts[33] = {0}, i, b;
+
+	for (i = 0; i < s->header.chunks; i++) {
+		if (!(s->chunks[i].flags & simpl_snapshot_chunk_free))
+			continue;
+		for (b = 0; b < 32 && (2U << b) <= s->chunks[i].size; b++);
+		counts[b]++;
+		bytes[b] += s->chunks[i].size;
+	}
+	printf("[Free Size Histogram]\n");
+	for (b = 0; b < 33; b++) {
+		if (counts[b])
+			printf("  [%10llu, %10llu)  %8u chunks  %12llu bytes\n", 1ULL << b, 2ULL << b,
+				counts[b], (unsigned long long)bytes[b]);
+	}
+}
+
+static void report_alignment(const struct snapshot *s)
+{
+	uint64_t align, fit, best;
+	uint32_t i;
+
+	printf("[Largest Allocatable]\n");
+	for (align = s->header.bytes_per_ptr; align <= (1U << 20); align <<= 2) {
+		for (best = 0, i = 0; i < s->header.chunks; i++) {
+			if (!(s->chunks[i].flags & simpl_snapshot_chunk_free))
+				continue;
+			fit = aligned_fit(s, &s->chunks[i], align);
+			best = fit > best? fit: best;
+		}
+		printf("  align %8llu  %10llu bytes\n", (unsigned long long)align, (unsigned long long)best);
+	}
+}
+
+static void report_lists(const struct snapshot *s)
+{
+	uint32_t i;
+
+	printf("[Freelists] fl_bitmap 0x%08x\n", s->header.fl_bitmap);
+	for (i = 0; i < s->header.freelists; i++) {
+		if (s->lengths[i])
+			printf("  fl %2u sl %u  %8u chunks\n", i >> 3, i & 7, s->lengths[i]);
+	}
+	for (i = 0; i < s->header.quick_lists; i++) {
+		if (s->quick_lengths[i])
+			printf("  quick %4u bytes  %8u chunks\n", s->header.chunk_min_size + i * s->header.bytes_per_ptr,
+				s->quick_lengths[i]);
+	}
+}
+
+/** @brief     Text map of address space.
+ *  @param[in] s Snapshot.
+ *  @note      '#' used, '.' free, '+' both, 'w' wilderness. */
+static void report_map(const struct snapshot *s)
+{
+	char line[map_columns + 1];
+	uint64_t cell = ((uint64_t)s->header.pool_size + map_columns * map_rows - 1) / (map_columns * map_rows);
+	uint64_t begin, end, b, e;
+	uint32_t i = 0, col, row;
+	int used, freed, wild;
+
+	if (!cell)
+		return;
+	printf("[Map] %llu bytes per cell, '#' used, '.' free, '+' both, 'w' wilderness\n", (unsigned long long)cell);
+	for (row = 0; row < map_rows; row++) {
+		for (col = 0; col < map_columns; col++) {
+			begin = (row * map_columns + col) * cell;
+			end = begin + cell;
+			used = freed = wild = 0;
+			for (; i < s->header.chunks; i++) {
+				b = s->chunks[i].offset;
+				e = b + s->header.chunk_overhead + s->chunks[i].size;
+				if (e <= begin)
+					continue;
+				if (b >= end)
+					break;
+				if (s->chunks[i].flags & simpl_snapshot_chunk_wilderness)
+					wild = 1;
+				else if (s->chunks[i].flags & simpl_snapshot_chunk_free)
+					freed = 1;
+				else
+					used = 1;
+				if (e > end)
+					break;
+			}
+			line[col] = begin >= s->header.pool_size? ' ': wild && !used? 'w': used && freed? '+': used? '#': '.';
+		}
+		line[map_columns] = '\0';
+		printf("  %08llx %s\n", (unsigned long long)(row * map_columns * cell), line);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct snapshot s;
+	FILE *file = stdin;
+	int ret = 0;
+
+	if (argc > 2 || (argc == 2 && !strcmp(argv[1], "-h"))) {
+		printf("usage: %s [snapshot]\n", argv[0]);
+		return 1;
+	}
+	if (argc == 2 && !(file = fopen(argv[1], "rb"))) {
+		perror(argv[1]);
+		return 1;
+	}
+	if (read_snapshot(file, &s)) {
+		fprintf(stderr, "%s: not a SIMPL snapshot of version %d\n", argc == 2? argv[1]: "stdin", SIMPL_SNAPSHOT_VERSION);
+		ret = 1;
+	} else {
+		printf("[SIMPL Snapshot] %s\n", argc == 2? argv[1]: "stdin");
+		report_summary(&s);
+		report_histogram(&s);
+		report_alignment(&s);
+		report_lists(&s);
+		report_map(&s);
+	}
+	free_snapshot(&s);
+	if (file != stdin)
+		fclose(file);
+	return ret;
+}
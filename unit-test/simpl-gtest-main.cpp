@@ -34,40 +34,138 @@
 #include "simpl-unit-test-memalign.c"
 #include "simpl-unit-test-realloc.c"
 #include "simpl-unit-test-drain.c"
+#include "simpl-unit-test-reset.c"
+#include "simpl-unit-test-defer.c"
+#include "simpl-unit-test-bestfit.c"
+#include "simpl-unit-test-ordered.c"
+#include "simpl-unit-test-hardened.c"
+#include "simpl-unit-test-profile.c"
+#include "simpl-unit-test-tag.c"
+#include "simpl-unit-test-numa.c"
+#include "simpl-unit-test-bulk.c"
+#include "simpl-unit-test-compact.c"
+#include "simpl-unit-test-snapshot.c"
+#include "simpl-unit-test-trace.c"
+#include "simpl-unit-test-registry.c"
+#include "simpl-unit-test-huge.c"
+#include "simpl-unit-test-trim.c"
+#include "simpl-unit-test-latency.c"
+#include "simpl-unit-test-reserve.c"
+#include "simpl-unit-test-child.c"
+#include "simpl-unit-test-static.c"
+#include "simpl-unit-test-bump.c"
+#include "simpl-unit-test-oob.c"
+#include "simpl-unit-test-uring.c"
+#include "simpl-unit-test-freelist.c"
 #include "simpl-unit-test-destruction.c"
 
-struct mempool simpl;
+struct mempool simpl_mp;
 
 TEST(SIMPL, Construction) {
-	EXPECT_EQ(0, construction_test(&simpl));
+	EXPECT_EQ(0, construction_test(&simpl_mp));
 }
 TEST(SIMPL, Realloc) {
-	EXPECT_EQ(0, realloc_test(&simpl));
+	EXPECT_EQ(0, realloc_test(&simpl_mp));
 }
 TEST(SIMPL, Memalign) {
-	EXPECT_EQ(0, memalign_test(&simpl));
+	EXPECT_EQ(0, memalign_test(&simpl_mp));
 }
 TEST(SIMPL, Drain) {
-	EXPECT_EQ(0, drain_test(&simpl));
+	EXPECT_EQ(0, drain_test(&simpl_mp));
+}
+TEST(SIMPL, Reset) {
+	EXPECT_EQ(0, reset_test(&simpl_mp));
+}
+TEST(SIMPL, Defer) {
+	EXPECT_EQ(0, defer_test(&simpl_mp));
+}
+TEST(SIMPL, Bestfit) {
+	EXPECT_EQ(0, bestfit_test(&simpl_mp));
+}
+TEST(SIMPL, Ordered) {
+	EXPECT_EQ(0, ordered_test(&simpl_mp));
+}
+TEST(SIMPL, Hardened) {
+	EXPECT_EQ(0, hardened_test(&simpl_mp));
+}
+TEST(SIMPL, Profile) {
+	EXPECT_EQ(0, profile_test(&simpl_mp));
+}
+TEST(SIMPL, Tag) {
+	EXPECT_EQ(0, tag_test(&simpl_mp));
+}
+TEST(SIMPL, Numa) {
+	EXPECT_EQ(0, numa_test(&simpl_mp));
+}
+TEST(SIMPL, Bulk) {
+	EXPECT_EQ(0, bulk_test(&simpl_mp));
+}
+TEST(SIMPL, Compact) {
+	EXPECT_EQ(0, compact_test(&simpl_mp));
+}
+TEST(SIMPL, Snapshot) {
+	EXPECT_EQ(0, snapshot_test(&simpl_mp));
+}
+TEST(SIMPL, Trace) {
+	EXPECT_EQ(0, trace_test(&simpl_mp));
+}
+TEST(SIMPL, Registry) {
+	EXPECT_EQ(0, registry_test(&simpl_mp));
+}
+TEST(SIMPL, Huge) {
+	EXPECT_EQ(0, huge_test(&simpl_mp));
+}
+TEST(SIMPL, Trim) {
+	EXPECT_EQ(0, trim_test(&simpl_mp));
+}
+TEST(SIMPL, Latency) {
+	EXPECT_EQ(0, latency_test(&simpl_mp));
+}
+TEST(SIMPL, Reserve) {
+	EXPECT_EQ(0, reserve_test(&simpl_mp));
+}
+TEST(SIMPL, Child) {
+	EXPECT_EQ(0, child_test(&simpl_mp));
+}
+TEST(SIMPL, Static) {
+	EXPECT_EQ(0, static_test(&simpl_mp));
+}
+TEST(SIMPL, Bump) {
+	EXPECT_EQ(0, bump_test(&simpl_mp));
+}
+TEST(SIMPL, OutOfBand) {
+	EXPECT_EQ(0, oob_test(&simpl_mp));
+}
+TEST(SIMPL, Uring) {
+	EXPECT_EQ(0, uring_test(&simpl_mp));
+}
+
+TEST(SIMPL, Freelist) {
+	EXPECT_EQ(0, freelist_test(&simpl_mp));
 }
 TEST(SIMPL, Destruction) {
-	EXPECT_EQ(0, destruction_test(&simpl));
+	EXPECT_EQ(0, destruction_test(&simpl_mp));
 }
 
 GTEST_API_ int main(int argc, char *argv[])
 {
 	testing::InitGoogleTest(&argc, argv);
 
-	memset(&simpl, 0, sizeof(struct mempool));
-	simpl.buffer_size = sizeof(char) * 1024U * 1024U * 1024U;
-	simpl.buffer = NULL;
-	simpl.init = simpl_init;
-	simpl.malloc = simpl_malloc;
-	simpl.free = simpl_free;
-	simpl.realloc = simpl_realloc,
-	simpl.memalign = simpl_memalign,
-	simpl.dump = NULL;
-	simpl.handle = NULL;
+	memset(&simpl_mp, 0, sizeof(struct mempool));
+	simpl_mp.buffer_size = sizeof(char) * 1024U * 1024U * 1024U;
+	simpl_mp.buffer = NULL;
+	simpl_mp.init = simpl_init;
+	simpl_mp.init_ex = simpl_init_ex;
+	simpl_mp.malloc = simpl_malloc;
+	simpl_mp.free = simpl_free;
+	simpl_mp.realloc = simpl_realloc,
+	simpl_mp.memalign = simpl_memalign,
+	simpl_mp.reset = simpl_reset;
+	simpl_mp.mark = simpl_mark;
+	simpl_mp.release = simpl_release_to_mark;
+	simpl_mp.stats = simpl_get_stats;
+	simpl_mp.dump = NULL;
+	simpl_mp.handle = NULL;
 
 	return RUN_ALL_TESTS();
 }
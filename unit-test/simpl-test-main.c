@@ -23,6 +23,12 @@
  *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
  *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
  *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* syscall */
+#endif
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
 #include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -36,6 +42,29 @@
 #include "simpl-unit-test-memalign.c"
 #include "simpl-unit-test-realloc.c"
 #include "simpl-unit-test-drain.c"
+#include "simpl-unit-test-reset.c"
+#include "simpl-unit-test-defer.c"
+#include "simpl-unit-test-bestfit.c"
+#include "simpl-unit-test-ordered.c"
+#include "simpl-unit-test-hardened.c"
+#include "simpl-unit-test-profile.c"
+#include "simpl-unit-test-tag.c"
+#include "simpl-unit-test-numa.c"
+#include "simpl-unit-test-bulk.c"
+#include "simpl-unit-test-compact.c"
+#include "simpl-unit-test-snapshot.c"
+#include "simpl-unit-test-trace.c"
+#include "simpl-unit-test-registry.c"
+#include "simpl-unit-test-huge.c"
+#include "simpl-unit-test-trim.c"
+#include "simpl-unit-test-latency.c"
+#include "simpl-unit-test-reserve.c"
+#include "simpl-unit-test-child.c"
+#include "simpl-unit-test-static.c"
+#include "simpl-unit-test-bump.c"
+#include "simpl-unit-test-oob.c"
+#include "simpl-unit-test-uring.c"
+#include "simpl-unit-test-freelist.c"
 #include "simpl-unit-test-destruction.c"
 
 #define TEST(func, mempool) \
@@ -46,14 +75,19 @@
 	} while(0)
 int main(int argc, char *argv[])
 {
-	struct mempool simpl = {
+	struct mempool simpl_mp = {
 		.buffer_size = 1U << 30 /* 1GB */, 
 		.buffer = NULL,
 		.init = simpl_init,
+		.init_ex = simpl_init_ex,
 		.malloc = simpl_malloc,
 		.free = simpl_free,
 		.realloc = simpl_realloc,
 		.memalign = simpl_memalign,
+		.reset = simpl_reset,
+		.mark = simpl_mark,
+		.release = simpl_release_to_mark,
+		.stats = simpl_get_stats,
 		.dump = NULL,
 		.handle = NULL,
 		.pool_overhead = 0, /* not support */
@@ -61,11 +95,34 @@ int main(int argc, char *argv[])
 	};
 
 	printf("[Mempool Test]\n");
-	TEST(construction_test, &simpl);
-	TEST(memalign_test, &simpl);
-	TEST(realloc_test, &simpl);
-	TEST(drain_test, &simpl);
-	TEST(destruction_test, &simpl);
+	TEST(construction_test, &simpl_mp);
+	TEST(memalign_test, &simpl_mp);
+	TEST(realloc_test, &simpl_mp);
+	TEST(drain_test, &simpl_mp);
+	TEST(reset_test, &simpl_mp);
+	TEST(defer_test, &simpl_mp);
+	TEST(bestfit_test, &simpl_mp);
+	TEST(ordered_test, &simpl_mp);
+	TEST(hardened_test, &simpl_mp);
+	TEST(profile_test, &simpl_mp);
+	TEST(tag_test, &simpl_mp);
+	TEST(numa_test, &simpl_mp);
+	TEST(bulk_test, &simpl_mp);
+	TEST(compact_test, &simpl_mp);
+	TEST(snapshot_test, &simpl_mp);
+	TEST(trace_test, &simpl_mp);
+	TEST(registry_test, &simpl_mp);
+	TEST(huge_test, &simpl_mp);
+	TEST(trim_test, &simpl_mp);
+	TEST(latency_test, &simpl_mp);
+	TEST(reserve_test, &simpl_mp);
+	TEST(child_test, &simpl_mp);
+	TEST(static_test, &simpl_mp);
+	TEST(bump_test, &simpl_mp);
+	TEST(oob_test, &simpl_mp);
+	TEST(uring_test, &simpl_mp);
+	TEST(freelist_test, &simpl_mp);
+	TEST(destruction_test, &simpl_mp);
 	printf("Finished!\n");
 
 	return 0;
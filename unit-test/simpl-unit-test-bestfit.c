@@ -0,0 +1,72 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-bestfit.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+/** @brief           Free two chunks of the same size class (1040 and 1120 bytes),
+ *                   the smaller last as head, then allocate the larger size
+ *                   which good-fit skips the class for.
+ *  @param[in] m     Mempool.
+ *  @param[in] flags simpl_flags of pool.
+ *  @return          Non-zero if the larger chunk reused. */
+static int bestfit_reuse(struct mempool *m, unsigned int flags)
+{
+	const size_t buffer_size = 1U << 16;
+	void *buffer, *handle, *small, *large, *p;
+	int reused;
+
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init_ex(buffer, buffer_size, flags);
+	if (!handle) {
+		free(buffer);
+		return -EFAULT;
+	}
+	small = m->malloc(handle, 1040);
+	m->malloc(handle, 8);
+	large = m->malloc(handle, 1120);
+	m->malloc(handle, 8);
+	m->free(handle, large);
+	m->free(handle, small); /* pushed last, head of the class */
+	p = m->malloc(handle, 1120);
+	reused = (p == large);
+	free(buffer);
+	return reused;
+}
+
+int bestfit_test(struct mempool *m)
+{
+	if (!m->init_ex || !m->malloc || !m->free)
+		return -EFAULT;
+	if (bestfit_reuse(m, 0) != 0)
+		return -EFAULT;
+	if (bestfit_reuse(m, simpl_flag_bestfit) != 1)
+		return -EFAULT;
+	return 0;
+}
@@ -0,0 +1,83 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-bulk.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int bulk_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 24, size = (3U << 20) + 12;
+	void *buffer, *handle, *p, *q;
+	uint8_t *b;
+	size_t i;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free || !m->realloc)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	memset(buffer, 0xa5, buffer_size); /* dirty pool for calloc */
+	handle = m->init(buffer, buffer_size);
+	if (!(p = simpl_calloc(handle, size, 1)) || !(q = simpl_calloc(handle, 10, 10)))
+		r = -ENOMEM;
+	for (i = 0, b = (uint8_t *)p; !r && i < size; i++)
+		r = b[i]? -EFAULT: 0;
+	for (i = 0, b = (uint8_t *)q; !r && i < 100; i++)
+		r = b[i]? -EFAULT: 0;
+	if (simpl_calloc(handle, (size_t)1 << 31, 4))
+		r = -EFAULT;
+	m->free(handle, q);
+
+	for (i = 0, b = (uint8_t *)p; i < size; i++)
+		b[i] = (uint8_t)(i * 7);
+	q = m->malloc(handle, 64); /* block expand with next, force moved */
+	b = (uint8_t *)m->realloc(handle, p, size * 2);
+	for (i = 0; b && !r && i < size; i++)
+		r = b[i] != (uint8_t)(i * 7)? -EFAULT: 0;
+	if (!b)
+		r = -ENOMEM;
+
+	m->free(handle, b);
+	m->free(handle, q);
+	q = m->malloc(handle, size / 2); /* expand with previous, overlapped move */
+	p = m->malloc(handle, size);
+	if (!q || !p || !m->malloc(handle, 64))
+		r = -ENOMEM;
+	m->free(handle, q);
+	for (i = 0, b = (uint8_t *)p; i < size; i++)
+		b[i] = (uint8_t)(i * 13);
+	b = (uint8_t *)m->realloc(handle, p, size + size / 4);
+	if (b != q)
+		r = -EFAULT;
+	for (i = 0; b && !r && i < size; i++)
+		r = b[i] != (uint8_t)(i * 13)? -EFAULT: 0;
+	if (!b)
+		r = -ENOMEM;
+	free(buffer);
+	return r;
+}
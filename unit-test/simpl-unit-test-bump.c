@@ -0,0 +1,86 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-bump.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int bump_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20;
+	const unsigned int flags[3] = {simpl_flag_bump, simpl_flag_bump | simpl_flag_address_ordered,
+		simpl_flag_bump | simpl_flag_defer_coalescing};
+	struct simpl_stats stats;
+	void *buffer, *handle, *mark, *p[64], *q;
+	size_t initial, used, size, i, f;
+	int r = 0;
+
+	if (!m->init_ex || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	for (f = 0; !r && f < 3; f++) {
+		handle = m->init_ex(buffer, buffer_size, flags[f]);
+		simpl_get_stats(handle, &stats);
+		initial = used = stats.available;
+		for (i = 0; !r && i < 64; i++) {
+			if (!(p[i] = m->malloc(handle, 8 + i * 24)))
+				r = -ENOMEM;
+			else if (i && (uint8_t *)p[i] <= (uint8_t *)p[i - 1]) /* carved in address order */
+				r = -EFAULT;
+			size = (8 + i * 24 + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+			used -= (size < 3 * sizeof(void *)? 3 * sizeof(void *): size) + sizeof(void *); /* with header */
+		}
+		simpl_get_stats(handle, &stats);
+		if (!r && stats.available != used)
+			r = -EFAULT;
+		m->free(handle, p[10]);
+		q = m->malloc(handle, 8 + 10 * 24);
+		if (!r && (!q || (q == p[10]) != !!(flags[f] & simpl_flag_defer_coalescing))) /* remainder after quick lists */
+			r = -EFAULT;
+		m->free(handle, q);
+		m->free(handle, p[63]); /* merged into remainder */
+		if (!r && m->malloc(handle, 8 + 63 * 24) != p[63])
+			r = -EFAULT;
+		mark = simpl_mark(handle);
+		if (!r && (!mark || !m->malloc(handle, 4096)))
+			r = -EFAULT;
+		simpl_release_to_mark(handle, mark);
+		for (i = 0; !r && i < 64; i++) {
+			if (i != 10)
+				m->free(handle, p[i]);
+		}
+		if (!r && !m->malloc(handle, buffer_size / 2))
+			r = -EFAULT;
+		simpl_reset(handle);
+		simpl_get_stats(handle, &stats);
+		if (!r && (stats.available != initial || !m->malloc(handle, initial / 2)))
+			r = -EFAULT;
+	}
+	free(buffer);
+	return r;
+}
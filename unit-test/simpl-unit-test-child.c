@@ -0,0 +1,118 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-child.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int child_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20, child_size = 1U << 14;
+	struct simpl_stats before, grown, after;
+	void *buffer, *handle, *child, *nested, *mark, *p[256];
+	size_t i, n;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	simpl_get_stats(handle, &before);
+	if (!(child = simpl_child_create(handle, child_size)))
+		r = -ENOMEM;
+	for (n = 0; !r && n < 256; n++) { /* 4 times of child buffer */
+		if (!(p[n] = m->malloc(child, 256)))
+			r = -ENOMEM;
+		else if ((uint8_t *)p[n] < (uint8_t *)buffer || (uint8_t *)p[n] >= (uint8_t *)buffer + buffer_size)
+			r = -EFAULT;
+		else
+			memset(p[n], (int)n, 256);
+	}
+	simpl_get_stats(handle, &grown);
+	if (!r && grown.available + 4 * child_size > before.available)
+		r = -EFAULT;
+	for (i = 0; !r && i < n; i += 2)
+		m->free(child, p[i]);
+	if (!r && (!(p[0] = m->realloc(child, p[1], 4096)) || m->malloc(child, child_size)))
+		r = -EFAULT;
+
+	nested = simpl_child_create(child, 4096);
+	if (!r && (!nested || !(p[2] = m->malloc(nested, 3000)) || !m->malloc(nested, 3000)))
+		r = -EFAULT;
+	if (!r && (simpl_owner_of(handle, p[2]) != nested || simpl_owner_of(handle, p[1]) != child ||
+		simpl_owner_of(handle, p[3]) != child || simpl_owner_of(handle, handle) != handle))
+		r = -EFAULT;
+	simpl_child_destroy(nested);
+	simpl_get_stats(handle, &grown);
+	simpl_reset(child); /* regions are kept */
+	for (i = 0; !r && i < 64; i++) {
+		if (!m->malloc(child, 256))
+			r = -EFAULT;
+	}
+	simpl_get_stats(handle, &after);
+	if (!r && after.available != grown.available)
+		r = -EFAULT;
+	simpl_child_destroy(child);
+	simpl_get_stats(handle, &after);
+	if (!r && after.available != before.available)
+		r = -EFAULT;
+	simpl_child_destroy(handle); /* not a child */
+	if (!r && (simpl_child_create(NULL, 4096) || simpl_child_create(handle, buffer_size) || !m->malloc(handle, 4096)))
+		r = -EFAULT;
+
+	simpl_reset(handle); /* children can't live in checkpoint region of parent */
+	child = simpl_child_create(handle, 4096);
+	if (!r && (!child || !(mark = simpl_mark(handle)) || simpl_child_create(handle, 4096)))
+		r = -EFAULT;
+	for (n = 0; !r && n < 64 && m->malloc(child, 256); n++); /* no region while parent checkpoint active */
+	if (!r && n >= 16)
+		r = -EFAULT;
+	if (!r) {
+		simpl_release_to_mark(handle, mark);
+		if (!(p[0] = m->malloc(handle, 8192)))
+			r = -ENOMEM;
+		else
+			memset(p[0], 0xa5, 8192);
+	}
+	if (!r && (simpl_owner_of(handle, p[0]) != handle || !m->malloc(child, 256)))
+		r = -EFAULT;
+	simpl_reset(handle);
+	free(buffer);
+
+	if (!r && (handle = simpl_pool_create(buffer_size, 0))) { /* free without handle goes to child */
+		child = simpl_child_create(handle, child_size);
+		simpl_get_stats(handle, &before);
+		if (!child || !(p[0] = m->malloc(child, 256)) || simpl_free_any(p[0]))
+			r = -EFAULT;
+		simpl_get_stats(handle, &after);
+		if (!r && (after.available != before.available || m->malloc(child, 256) != p[0]))
+			r = -EFAULT;
+		simpl_pool_destroy(handle);
+	}
+	return r;
+}
@@ -0,0 +1,87 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-compact.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int compact_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 18, size = 1000;
+	const unsigned int flags[] = {0, simpl_flag_defer_coalescing, simpl_flag_address_ordered};
+	struct simpl_stats stats;
+	simpl_handle h[512];
+	void *buffer, *handle, *pinned, *p;
+	uint8_t *b;
+	size_t i, j, steps, count, before;
+	int f, r = 0;
+
+	if (!m->init_ex || !m->malloc || !m->free || !m->stats)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	for (f = 0; f < 3 && !r; f++) {
+		handle = m->init_ex(buffer, buffer_size, flags[f]);
+		for (count = 0; count < 512 && (h[count] = simpl_halloc(handle, size)); count++) { /* fill pool */
+			b = (uint8_t *)simpl_hlock(handle, h[count]);
+			memset(b, (int)count, size);
+			simpl_hunlock(handle, h[count]);
+		}
+		if (count < 64 || count == 512)
+			r = -ENOMEM;
+		for (i = 0; i < count; i += 2) { /* checkerboard holes */
+			simpl_hfree(handle, h[i]);
+			h[i] = 0;
+		}
+		m->stats(handle, &stats);
+		before = stats.largest_free;
+		pinned = simpl_hlock(handle, h[count / 2 + 1]);
+		for (steps = 0; steps < 10000 && simpl_compact(handle, 4096); steps++) {
+			if ((p = m->malloc(handle, 64))) /* cursor survives merges */
+				m->free(handle, p);
+		}
+		simpl_compact(handle, SIZE_MAX);
+		m->stats(handle, &stats);
+		if (stats.largest_free < (count / 4) * size || stats.largest_free < before * 8)
+			r = -EFAULT;
+		if (simpl_hlock(handle, h[count / 2 + 1]) != pinned)
+			r = -EFAULT;
+		simpl_hunlock(handle, h[count / 2 + 1]);
+		simpl_hunlock(handle, h[count / 2 + 1]);
+		for (i = 1; i < count && !r; i += 2) {
+			b = (uint8_t *)simpl_hlock(handle, h[i]);
+			for (j = 0; b && j < size; j++)
+				r = b[j] != (uint8_t)i? -EFAULT: r;
+			simpl_hunlock(handle, h[i]);
+			simpl_hfree(handle, h[i]);
+		}
+		if (simpl_hlock(handle, h[1]) || simpl_hlock(handle, 0))
+			r = -EFAULT;
+	}
+	free(buffer);
+	return r;
+}
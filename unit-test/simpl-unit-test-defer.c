@@ -0,0 +1,63 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-defer.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int defer_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16, size = 48;
+	struct simpl_stats stats;
+	void *buffer, *handle, *mem[2048], *p;
+	int i, n, r = 0;
+
+	if (!m->init_ex || !m->malloc || !m->free || !m->stats)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init_ex(buffer, buffer_size, simpl_flag_defer_coalescing);
+	if (!handle) {
+		free(buffer);
+		return -EFAULT;
+	}
+	for (n = 0; n < 2048 && (mem[n] = m->malloc(handle, size)); n++);
+	m->free(handle, mem[10]);
+	m->stats(handle, &stats);
+	p = m->malloc(handle, size); /* served by quick list */
+	if (!stats.deferred || p != mem[10])
+		r = -EFAULT;
+	for (i = 0; i < n; i++)
+		m->free(handle, mem[i]);
+
+	for (i = 0; i < 2048 && (mem[i] = m->malloc(handle, size * 2)); i++); /* coalesce deferred chunks when drained */
+	m->stats(handle, &stats);
+	if (stats.deferred || i < n / 2 - 1)
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,62 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-freelist.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int freelist_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16, size = 1024; /* lower bound of its size class */
+	void *buffer, *handle, *a, *b, *c, *p;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	a = m->malloc(handle, size);
+	p = m->malloc(handle, 256); /* merged with a into larger class */
+	m->malloc(handle, 8);
+	b = m->malloc(handle, size);
+	m->malloc(handle, 8);
+	c = m->malloc(handle, size);
+	m->malloc(handle, 8);
+	if (!a || !p || !b || !c) {
+		free(buffer);
+		return -ENOMEM;
+	}
+	m->free(handle, a); /* tail of the class list: c, b, a */
+	m->free(handle, b);
+	m->free(handle, c);
+	m->free(handle, p); /* merge pops a, c and b stay listed */
+	if (m->malloc(handle, size) != c || m->malloc(handle, size) != b)
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,72 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-hardened.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+static int hardened_detections = 0;
+
+static void hardened_handler(void *simp, void *chunk, const char *reason)
+{
+	hardened_detections++;
+}
+
+int hardened_test(struct mempool *m)
+{
+#ifdef SIMPL_HARDENED
+	const size_t buffer_size = 1U << 16;
+	const unsigned int flags[] = {0, simpl_flag_defer_coalescing};
+	void *buffer, *handle, *p, *q;
+	int i, r = 0;
+
+	if (!m->init_ex || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	simpl_set_corruption_handler(hardened_handler);
+	for (i = 0; i < 2; i++) {
+		hardened_detections = 0;
+		handle = m->init_ex(buffer, buffer_size, flags[i]);
+		p = m->malloc(handle, 64);
+		q = m->malloc(handle, 64);
+		m->free(handle, p);
+		m->free(handle, p); /* double free */
+		if (hardened_detections != 1)
+			r = -EFAULT;
+		memset((uint8_t *)q - sizeof(void *), 0x5a, sizeof(void *)); /* overflow into header */
+		m->free(handle, q);
+		if (hardened_detections != 2)
+			r = -EFAULT;
+	}
+	simpl_set_corruption_handler(NULL);
+	free(buffer);
+	return r;
+#else
+	return 0;
+#endif//SIMPL_HARDENED
+}
@@ -0,0 +1,111 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-huge.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+#define huge_inside(p, buffer, size) \
+	((uint8_t *)(p) >= (uint8_t *)(buffer) && (uint8_t *)(p) < (uint8_t *)(buffer) + (size))
+
+int huge_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20, threshold = 1U << 16, size = 3U << 16;
+	struct simpl_stats stats;
+	void *buffer, *handle, *mark, *small, *p, *q;
+	uint8_t *b;
+	size_t i;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free || !m->realloc)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	small = m->malloc(handle, threshold - 64);
+	simpl_set_huge_threshold(handle, threshold);
+	p = m->malloc(handle, size);
+	simpl_get_stats(handle, &stats);
+	if (!p || !small || !huge_inside(small, buffer, buffer_size)) {
+		r = -ENOMEM;
+	} else if (huge_inside(p, buffer, buffer_size) || stats.huge < size) {
+		m->free(handle, p); /* mapping not supported, fell back to pool */
+		m->free(handle, small);
+		free(buffer);
+		return stats.huge? -EFAULT: 0;
+	}
+
+	for (i = 0, b = (uint8_t *)p; !r && i < size; i++)
+		b[i] = (uint8_t)(i * 7);
+	q = m->realloc(handle, p, (size_t)64 << 20); /* remapped */
+	for (i = 0, b = (uint8_t *)q; q && !r && i < size; i++)
+		r = b[i] != (uint8_t)(i * 7)? -EFAULT: 0;
+	simpl_get_stats(handle, &stats);
+	if (!q || huge_inside(q, buffer, buffer_size) || stats.huge < ((size_t)64 << 20))
+		r = r? r: -EFAULT;
+	p = q? q: p;
+	if (!r && (q = m->realloc(handle, p, 100)) && q != p) /* shrink keeps huge block */
+		r = -EFAULT;
+	m->free(handle, p);
+
+	for (i = 0, b = (uint8_t *)small; i < threshold - 64; i++)
+		b[i] = (uint8_t)(i * 13);
+	q = m->realloc(handle, small, threshold * 2); /* leave pool */
+	for (i = 0, b = (uint8_t *)q; q && !r && i < threshold - 64; i++)
+		r = b[i] != (uint8_t)(i * 13)? -EFAULT: 0;
+	if (!q || huge_inside(q, buffer, buffer_size))
+		r = r? r: -EFAULT;
+	m->free(handle, q);
+
+	b = (uint8_t *)simpl_calloc(handle, threshold, 4);
+	for (i = 0; b && !r && i < threshold * 4; i++)
+		r = b[i]? -EFAULT: 0;
+	m->free(handle, b);
+	simpl_get_stats(handle, &stats);
+	if (!b || stats.huge || stats.available + stats.deferred < buffer_size / 2)
+		r = r? r: -EFAULT;
+
+	mark = simpl_mark(handle);
+	if (!mark || !m->malloc(handle, size) || !m->malloc(handle, size * 2))
+		r = r? r: -ENOMEM;
+	simpl_release_to_mark(handle, mark);
+	simpl_get_stats(handle, &stats);
+	if (stats.huge)
+		r = r? r: -EFAULT;
+	if (!m->malloc(handle, size))
+		r = r? r: -ENOMEM;
+	simpl_reset(handle);
+	simpl_get_stats(handle, &stats);
+	if (stats.huge)
+		r = r? r: -EFAULT;
+
+	simpl_set_huge_threshold(handle, 0);
+	if (!huge_inside(p = m->malloc(handle, size), buffer, buffer_size))
+		r = r? r: -EFAULT;
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,82 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-latency.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int latency_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20;
+	struct simpl_latency_histogram histograms[simpl_latency_ops];
+	void *buffer, *handle, *p, *q, *guard;
+	uint64_t sum;
+	unsigned int i, j;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	p = simpl_malloc(handle, 100);
+	q = simpl_memalign(handle, 64, 100);
+	guard = simpl_malloc(handle, 100);
+	p = simpl_realloc(handle, p, 50); /* in place */
+	p = simpl_realloc(handle, p, 4096); /* guarded, copied */
+	simpl_free(handle, guard);
+	simpl_free(handle, q);
+	simpl_free(handle, p);
+	simpl_free(handle, simpl_calloc(handle, 4, 25)); /* timed as malloc */
+#ifdef SIMPL_LATENCY
+	if (simpl_get_latency_histograms(handle, histograms, simpl_latency_ops) != simpl_latency_ops)
+		r = -EFAULT;
+	if (!r && (histograms[simpl_latency_malloc].count != 3 || histograms[simpl_latency_free].count != 4 ||
+		histograms[simpl_latency_realloc].count != 2 || histograms[simpl_latency_memalign].count != 1 ||
+		histograms[simpl_latency_realloc_copy].count != 1 || histograms[simpl_latency_realloc_merge].count))
+		r = -EFAULT;
+	for (i = 0; !r && i < simpl_latency_ops; i++) {
+		for (sum = 0, j = 0; j < SIMPL_LATENCY_BUCKETS; j++)
+			sum += histograms[i].buckets[j];
+		if (sum != histograms[i].count)
+			r = -EFAULT;
+	}
+	for (i = 1; !r && i < SIMPL_LATENCY_BUCKETS; i++)
+		if (simpl_latency_bucket_limit(i) <= simpl_latency_bucket_limit(i - 1))
+			r = -EFAULT;
+	handle = m->init(buffer, 4096); /* too small to be timed */
+	if (!r && simpl_get_latency_histograms(handle, histograms, simpl_latency_ops) != -ENOSPC)
+		r = -EFAULT;
+#else
+	if (simpl_get_latency_histograms(handle, histograms, simpl_latency_ops) != -ENOTSUP)
+		r = -EFAULT;
+#endif//SIMPL_LATENCY
+	if (!r && simpl_get_latency_histograms(NULL, histograms, simpl_latency_ops) != -EINVAL)
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,96 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-oob.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int oob_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20, page = 4096;
+	struct simpl_stats initial, stats;
+	void *buffer, *oob, *p[4], *q;
+	size_t n;
+	int r = 0;
+
+	(void)m;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	if (simpl_oob_init(buffer, buffer_size, 3000) || simpl_oob_init(buffer, 64, page) ||
+		!(oob = simpl_oob_init(buffer, buffer_size, page))) {
+		free(buffer);
+		return -EFAULT;
+	}
+	simpl_oob_get_stats(oob, &initial);
+	if (initial.available + page + 8 * sizeof(void *) < buffer_size * 254 / 256 || initial.largest_free != initial.available)
+		r = -EFAULT;
+
+	p[0] = simpl_oob_malloc(oob, 1);
+	p[1] = simpl_oob_malloc(oob, 10000);
+	p[2] = simpl_oob_memalign(oob, 16 * page, page);
+	p[3] = simpl_oob_malloc(oob, page);
+	if (!r && (!p[0] || !p[1] || !p[2] || !p[3] || (uintptr_t)p[0] & (page - 1) || (uintptr_t)p[2] & (16 * page - 1)))
+		r = -EFAULT;
+	if (!r && ((uint8_t *)p[1] != (uint8_t *)p[0] + page || /* no header between */
+		simpl_oob_usable_size(oob, p[0]) != page || simpl_oob_usable_size(oob, p[1]) != 3 * page))
+		r = -EFAULT;
+	simpl_oob_get_stats(oob, &stats);
+	if (!r && stats.available != initial.available - 6 * page)
+		r = -EFAULT;
+	if (!r)
+		memset(p[1], 0xa5, 3 * page); /* side table is not in payloads */
+
+	simpl_oob_free(oob, (uint8_t *)p[1] + page); /* interior of element, not an element */
+	simpl_oob_get_stats(oob, &stats);
+	if (!r && (stats.available != initial.available - 6 * page || simpl_oob_usable_size(oob, p[1]) != 3 * page))
+		r = -EFAULT;
+	simpl_oob_free(oob, p[1]);
+	simpl_oob_free(oob, p[1]); /* freed twice */
+	simpl_oob_get_stats(oob, &stats);
+	if (!r && (stats.available != initial.available - 3 * page || simpl_oob_usable_size(oob, p[1])))
+		r = -EFAULT;
+	if (!r && (q = simpl_oob_malloc(oob, 2 * page)) != p[1]) /* hole of p[1] before p[2] fits */
+		r = -EFAULT;
+	simpl_oob_free(oob, q);
+	for (n = 0; n < 4; n++)
+		simpl_oob_free(oob, p[n]);
+	simpl_oob_get_stats(oob, &stats);
+	if (!r && (stats.available != initial.available || stats.largest_free != initial.available))
+		r = -EFAULT;
+
+	for (n = 0; simpl_oob_malloc(oob, page); n++)
+		continue;
+	if (!r && n != initial.available / page)
+		r = -EFAULT;
+
+	if (!r && (!(oob = simpl_oob_init(buffer, buffer_size, 64)) || /* cache lines */
+		(uintptr_t)(p[0] = simpl_oob_malloc(oob, 64)) & 63 ||
+		simpl_oob_malloc(oob, 100) != (uint8_t *)p[0] + 64 || simpl_oob_malloc(oob, initial.available)))
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
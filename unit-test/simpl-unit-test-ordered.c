@@ -0,0 +1,80 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-ordered.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+/** @brief           Free two chunks of the same size from low to high address,
+ *                   then allocate the same size.
+ *  @param[in] m     Mempool.
+ *  @param[in] flags simpl_flags of pool.
+ *  @return          Non-zero if the lower chunk reused. */
+static int ordered_reuse(struct mempool *m, unsigned int flags)
+{
+	const size_t buffer_size = 1U << 16;
+	struct simpl_stats stats;
+	void *buffer, *handle, *low, *high, *p;
+	int reused;
+
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init_ex(buffer, buffer_size, flags);
+	if (!handle) {
+		free(buffer);
+		return -EFAULT;
+	}
+	low = m->malloc(handle, 64);
+	m->malloc(handle, 8);
+	high = m->malloc(handle, 64);
+	p = m->malloc(handle, 8);
+	m->free(handle, low);
+	m->free(handle, high);
+	reused = (m->malloc(handle, 64) == low);
+
+	m->free(handle, p); /* merge into wilderness, which fits exactly */
+	m->stats(handle, &stats);
+	if (flags & simpl_flag_address_ordered)
+		p = m->malloc(handle, stats.largest_free);
+	else
+		p = m->malloc(handle, stats.largest_free / 2);
+	if (!p)
+		reused = -EFAULT;
+	free(buffer);
+	return reused;
+}
+
+int ordered_test(struct mempool *m)
+{
+	if (!m->init_ex || !m->malloc || !m->free || !m->stats)
+		return -EFAULT;
+	if (ordered_reuse(m, 0) != 0)
+		return -EFAULT;
+	if (ordered_reuse(m, simpl_flag_address_ordered) != 1)
+		return -EFAULT;
+	return 0;
+}
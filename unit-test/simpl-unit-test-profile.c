@@ -0,0 +1,78 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-profile.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+#ifdef _WIN32
+#define profile_fileno(stream) _fileno(stream)
+#else
+#define profile_fileno(stream) fileno(stream)
+#endif//_WIN32
+
+int profile_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 20;
+	void *buffer, *handle, *p[16];
+	unsigned int objs = 0, period = 0;
+	unsigned long long bytes = 0;
+	FILE *file;
+	int i, r = 0;
+
+	if (!m->init || !m->malloc || !m->free || !m->realloc)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	if (simpl_profile_start(handle, 1, 64) || simpl_profile_start(handle, 1, 64) != -EBUSY)
+		r = -EFAULT;
+	for (i = 0; i < 16; i++) /* period smaller than chunk, every element sampled */
+		p[i] = m->malloc(handle, 100);
+	for (i = 0; i < 16; i += 2)
+		m->free(handle, p[i]);
+	if (m->realloc(handle, p[1], buffer_size)) /* failed, sample of p[1] kept */
+		r = -EFAULT;
+	file = tmpfile();
+	if (!file) {
+		r = -ENOENT;
+	} else {
+		if (simpl_profile_dump(handle, profile_fileno(file)))
+			r = -EIO;
+		rewind(file);
+		if (fscanf(file, "heap profile: %u: %llu [%*u: %*u] @ heap_v2/%u", &objs, &bytes, &period) != 3 ||
+			objs != 8 || bytes < 8 * 100 || period != 1)
+			r = -EFAULT;
+		fclose(file);
+	}
+	simpl_profile_stop(handle);
+	if (simpl_profile_dump(handle, 0) != -EINVAL)
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,93 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-registry.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int registry_test(struct mempool *m)
+{
+	const size_t sizes[4] = {4096, 3U << 20, 1U << 20, 123457};
+	struct simpl_stats before, after;
+	void *pools[4], *p[4][8], *outside, *huge[2] = {NULL, NULL}, *child = NULL;
+	int i, j, r = 0;
+
+	(void)m;
+	for (i = 0; i < 4; i++) {
+		if (!(pools[i] = simpl_pool_create(sizes[i], i & 1? simpl_flag_defer_coalescing: 0)))
+			r = -ENOMEM;
+		for (j = 0; !r && j < 8; j++) {
+			if (!(p[i][j] = simpl_malloc(pools[i], 64 + (size_t)j * 60)))
+				r = -ENOMEM;
+		}
+	}
+	for (i = 0; !r && i < 4; i++) {
+		for (j = 0; !r && j < 8; j++)
+			r = simpl_pool_of(p[i][j]) == pools[i]? 0: -EFAULT;
+		r = r? r: simpl_pool_of(pools[i]) == pools[i]? 0: -EFAULT;
+	}
+	outside = malloc(64);
+	if (!r && (simpl_pool_of(outside) || simpl_pool_of(&r) || simpl_pool_of(NULL) ||
+		simpl_free_any(outside) != -ENOENT || simpl_free_any(NULL)))
+		r = -EFAULT;
+	free(outside);
+
+	for (i = 0; !r && i < 4; i++) {
+		simpl_get_stats(pools[i], &before);
+		for (j = 0; !r && j < 8; j++)
+			r = simpl_free_any(p[i][j]);
+		simpl_get_stats(pools[i], &after);
+		if (!r && after.available + after.deferred <= before.available + before.deferred)
+			r = -EFAULT;
+	}
+#if !defined(_WIN32)
+	if (!r) { /* huge blocks mapped in registered super-regions */
+		simpl_set_huge_threshold(pools[1], 1U << 16);
+		if (!(huge[0] = simpl_malloc(pools[1], 1U << 20)) || simpl_pool_of(huge[0]) != pools[1] ||
+			!(huge[0] = simpl_realloc(pools[1], huge[0], 5U << 20)) || simpl_pool_of(huge[0]) != pools[1] ||
+			simpl_pool_of((uint8_t *)huge[0] + (5U << 20) - 1) != pools[1])
+			r = -EFAULT;
+		else if (simpl_free_any(huge[0]) || (simpl_get_stats(pools[1], &after), after.huge))
+			r = -EFAULT;
+	}
+	if (!r) { /* kept for simpl_pool_destroy */
+		if (!(huge[0] = simpl_malloc(pools[1], 1U << 20)) || !(child = simpl_child_create(pools[1], 1U << 15)) ||
+			(simpl_set_huge_threshold(child, 1U << 12), !(huge[1] = simpl_malloc(child, 1U << 14))) ||
+			simpl_pool_of(huge[1]) != child)
+			r = -EFAULT;
+	}
+#endif//_WIN32
+	for (i = 0; i < 4; i++) {
+		simpl_pool_destroy(pools[i]);
+		if (!r && pools[i] && simpl_pool_of(p[i][0]))
+			r = -EFAULT;
+	}
+	if (!r && ((huge[0] && simpl_pool_of(huge[0])) || (huge[1] && simpl_pool_of(huge[1]))))
+		r = -EFAULT;
+	if (simpl_pool_create(0, 0) || simpl_pool_create((size_t)UINT32_MAX + 1, 0))
+		r = -EFAULT;
+	return r;
+}
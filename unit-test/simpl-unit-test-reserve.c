@@ -0,0 +1,110 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-reserve.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int reserve_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 18, count = 64;
+	struct simpl_stats stats, reserved;
+	simpl_handle h;
+	void *buffer, *handle, *p[64];
+	uint8_t *low, *high;
+	size_t i, carved;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	simpl_get_stats(handle, &stats);
+	if (simpl_reserve(handle, 100, count, 1) != count)
+		r = -EFAULT;
+	simpl_get_stats(handle, &reserved);
+	if (!r && (reserved.available >= stats.available || reserved.available + count * 16 < stats.available))
+		r = -EFAULT;
+	for (i = 0; i < count; i++) {
+		if (!(p[i] = m->malloc(handle, 100)))
+			r = -ENOMEM;
+		else
+			memset(p[i], (int)i, 100);
+	}
+	simpl_get_stats(handle, &stats);
+	if (!r && stats.largest_free != reserved.largest_free) /* remainder not split */
+		r = -EFAULT;
+	for (low = high = (uint8_t *)p[0], i = 1; !r && i < count; i++) {
+		low = (uint8_t *)p[i] < low? (uint8_t *)p[i]: low;
+		high = (uint8_t *)p[i] > high? (uint8_t *)p[i]: high;
+	}
+	if (!r && (size_t)(high - low) >= count * 128) /* contiguous */
+		r = -EFAULT;
+	for (i = 0; i < count; i += 2)
+		m->free(handle, p[i]);
+	for (i = 1; i < count; i += 2)
+		m->free(handle, p[i]);
+	simpl_get_stats(handle, &stats);
+	if (!r && stats.largest_free < buffer_size / 2)
+		r = -EFAULT;
+
+	carved = simpl_reserve(handle, 4000, SIZE_MAX, 0);
+	if (!r && (carved < buffer_size / 8192 || carved >= buffer_size / 4000))
+		r = -EFAULT;
+	if (!r && (!m->malloc(handle, 4000) || simpl_reserve(handle, 0, 1, 0) || simpl_reserve(NULL, 8, 1, 0)))
+		r = -EFAULT;
+	simpl_reset(handle);
+	if (!r && !m->malloc(handle, buffer_size / 2))
+		r = -EFAULT;
+
+	simpl_reset(handle); /* compact slides over run of carved free chunks */
+	h = simpl_halloc(handle, 40);
+	simpl_hfree(handle, h);
+	if (!r && (!h || simpl_reserve(handle, 48, 8, 0) != 8 || !(h = simpl_halloc(handle, 200))))
+		r = -EFAULT;
+	if (!r) {
+		high = (uint8_t *)simpl_hlock(handle, h);
+		memset(high, 0x5a, 200);
+		simpl_hunlock(handle, h);
+		simpl_compact(handle, SIZE_MAX);
+		low = (uint8_t *)simpl_hlock(handle, h);
+		for (i = 0; i < 200 && low[i] == 0x5a; i++);
+		simpl_hunlock(handle, h);
+		simpl_get_stats(handle, &stats);
+		if (i != 200 || low >= high || stats.largest_free != stats.available) /* one free chunk after slide */
+			r = -EFAULT;
+	}
+
+	simpl_reset(handle); /* trim takes whole run of carved free chunks, minimal first chunk kept */
+	simpl_get_stats(handle, &stats);
+	if (!r && (simpl_reserve(handle, 100, 16, 0) != 16 || simpl_trim(handle, NULL) + 256 < stats.available))
+		r = -EFAULT;
+	simpl_reset(handle);
+	free(buffer);
+	return r;
+}
@@ -0,0 +1,88 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-reset.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int reset_test(struct mempool *m)
+{
+	const size_t size = 100;
+	struct simpl_stats before_outer, before_inner, stats;
+	void *first, *p, *e, *q, *outer, *inner;
+	int i;
+
+	if (!m->handle || !m->malloc || !m->free || !m->reset || !m->mark || !m->release || !m->stats)
+		return -EFAULT;
+	first = m->malloc(m->handle, size);
+	if (!first)
+		return -ENOMEM;
+	for (i = 0; i < 1000; i++) {
+		if (!m->malloc(m->handle, size * i + 1))
+			return -ENOMEM;
+	}
+	m->reset(m->handle);
+	p = m->malloc(m->handle, size);
+	if (p != first)
+		return -EFAULT;
+
+	m->stats(m->handle, &before_outer);
+	outer = m->mark(m->handle);
+	if (!outer)
+		return -ENOMEM;
+	first = m->malloc(m->handle, size);
+	m->stats(m->handle, &before_inner);
+	inner = m->mark(m->handle);
+	if (!first || !inner)
+		return -ENOMEM;
+	for (i = 0, q = NULL; i < 1000; i++) {
+		if (!(e = m->malloc(m->handle, size * i + 1)))
+			return -ENOMEM;
+		q = i == 500? e: q;
+	}
+	m->free(m->handle, q); /* element after inner mark */
+	m->release(m->handle, inner);
+	m->stats(m->handle, &stats);
+	if (stats.available != before_inner.available || stats.largest_free != before_inner.largest_free)
+		return -EFAULT;
+
+	inner = m->mark(m->handle);
+	if (!inner || !m->malloc(m->handle, size))
+		return -ENOMEM;
+	m->release(m->handle, outer); /* inner released too */
+	m->stats(m->handle, &stats);
+	if (stats.available != before_outer.available || stats.largest_free != before_outer.largest_free)
+		return -EFAULT;
+
+	outer = m->mark(m->handle);
+	if (!outer)
+		return -ENOMEM;
+	if (m->malloc(m->handle, size) != first)
+		return -EFAULT;
+	m->release(m->handle, outer);
+	m->free(m->handle, p);
+	return 0;
+}
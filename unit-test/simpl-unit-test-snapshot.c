@@ -0,0 +1,84 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-snapshot.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+#include "src/simpl-snapshot.h"
+
+int snapshot_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16;
+	struct simpl_snapshot_header header;
+	struct simpl_snapshot_chunk chunk;
+	void *buffer, *handle, *p[16];
+	uint64_t total = 0;
+	uint32_t i, used = 0, lengths = 0, length;
+	FILE *file;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	for (i = 0; i < 16; i++)
+		p[i] = m->malloc(handle, 100 + i * 40);
+	for (i = 0; i < 16; i += 2)
+		m->free(handle, p[i]); /* 8 holes, odd ones used */
+	if (simpl_snapshot(handle, -1) != -EINVAL)
+		r = -EFAULT;
+	if (!(file = tmpfile())) {
+		free(buffer);
+		return -ENOENT;
+	}
+	if (!r && !(r = simpl_snapshot(handle, fileno(file)))) {
+		fseek(file, 0, SEEK_SET);
+		if (fread(&header, sizeof(header), 1, file) != 1 ||
+			memcmp(header.magic, SIMPL_SNAPSHOT_MAGIC, sizeof(header.magic)) ||
+			header.version != SIMPL_SNAPSHOT_VERSION || header.header_size != sizeof(header))
+			r = -EFAULT;
+		for (i = 0; !r && i < header.freelists + header.quick_lists; i++) {
+			if (fread(&length, sizeof(length), 1, file) != 1)
+				r = -EFAULT;
+			lengths += length;
+		}
+		for (i = 0; !r && i < header.chunks; i++) {
+			if (fread(&chunk, sizeof(chunk), 1, file) != 1 || chunk.offset != total)
+				r = -EFAULT;
+			total += header.chunk_overhead + chunk.size;
+			used += (chunk.flags & simpl_snapshot_chunk_free)? 0: 1;
+		}
+		/* chunks tile the pool, parked chunks count as used */
+		if (!r && (total != header.pool_size || used < 8 || lengths < 8 || fgetc(file) != EOF))
+			r = -EFAULT;
+	}
+	fclose(file);
+	free(buffer);
+	return r;
+}
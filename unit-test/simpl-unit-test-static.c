@@ -0,0 +1,106 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-static.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+#ifdef __cplusplus
+#include "simpl.hpp"
+
+static simpl::static_pool<1U << 16> static_test_pool; /* constant initialized, no startup cost */
+
+static_assert(simpl::size_class<1>::chunk_size == 3 * sizeof(void *), "minimal chunk");
+static_assert(simpl::size_class<100>::chunk_size % sizeof(void *) == 0, "pointer aligned");
+static_assert(simpl::static_pool<1U << 16>::freelists > simpl::size_class<(1U << 15)>::index, "freelists index pool");
+
+/** @brief  C++ static pool, compiled by simpl-gtest-main only.
+ *  @return 0 if succeed. */
+static int static_pool_test(void)
+{
+	simpl::static_pool<1U << 14> scratch; /* on stack */
+	void *p[16];
+	int i, r = 0;
+
+	for (i = 0; i < 16; i++) {
+		if (!(p[i] = static_test_pool.malloc<200>()))
+			return -ENOMEM;
+		memset(p[i], i, 200);
+	}
+	if (!scratch.malloc<4000>() || !scratch.malloc(100) || scratch.malloc<(1U << 14)>())
+		r = -EFAULT;
+	for (i = 0; !r && i < 16; i++) {
+		if ((uint8_t *)p[i] < (uint8_t *)static_test_pool.handle() ||
+			(uint8_t *)p[i] >= (uint8_t *)static_test_pool.handle() + (1U << 16) || *((uint8_t *)p[i] + 199) != i)
+			r = -EFAULT;
+	}
+	for (i = 0; i < 16; i++)
+		static_test_pool.free(p[i]);
+	static_test_pool.reset();
+	scratch.reset();
+	return r;
+}
+#endif//__cplusplus
+
+int static_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16;
+	struct simpl_stats stats;
+	void *buffer, *handle, *small, *p, *q;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	if (simpl_init_static(buffer, buffer_size, 0, 0) || simpl_init_static(buffer, buffer_size, 0, 24 * 8 + 1))
+		r = -EFAULT;
+	handle = simpl_init_static(buffer, buffer_size, 0, 24 * 8);
+	if (!r && !handle)
+		r = -EFAULT;
+	small = m->malloc(handle, 24);
+	if (!r && (!small || !m->malloc(handle, 24)))
+		r = -EFAULT;
+	m->free(handle, small); /* the only chunk of class 6 */
+	p = simpl_malloc_class(handle, 1024, 6); /* wrong class falls back */
+	q = simpl_malloc_class(handle, 100, 0); /* not pointer aligned */
+	if (!r && (!p || p == small || !q || q == small))
+		r = -EFAULT;
+	if (!r) {
+		memset(p, 0x5a, 1024);
+		memset(q, 0xa5, 100);
+	}
+	m->free(handle, p);
+	m->free(handle, q);
+	simpl_get_stats(handle, &stats);
+	if (!r && (simpl_malloc_class(handle, buffer_size, 0) || stats.largest_free < buffer_size / 2))
+		r = -EFAULT;
+#ifdef __cplusplus
+	r = r? r: static_pool_test();
+#endif//__cplusplus
+	free(buffer);
+	return r;
+}
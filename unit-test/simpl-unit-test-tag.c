@@ -0,0 +1,86 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-tag.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int tag_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16;
+	const unsigned int flags[] = {simpl_flag_tagged, simpl_flag_tagged | simpl_flag_defer_coalescing};
+	void *buffer, *handle, *a, *b, *c, *mark;
+	size_t usage;
+	int i, r = 0;
+
+	if (!m->init_ex || !m->malloc || !m->free || !m->realloc || !m->mark || !m->release)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	for (i = 0; i < 2 && !r; i++) {
+		handle = m->init_ex(buffer, buffer_size, flags[i]);
+		if (!handle) { /* tag needs header padding of 64-bit */
+			r = sizeof(void *) < 8? 0: -EFAULT;
+			break;
+		}
+		a = simpl_malloc_tagged(handle, 100, 1);
+		b = simpl_malloc_tagged(handle, 200, 2);
+		c = m->malloc(handle, 50);
+		if (!a || !b || !c || simpl_malloc_tagged(handle, 1, SIMPL_TAGS))
+			r = -ENOMEM;
+		if (simpl_tag_usage(handle, 1) < 100 || simpl_tag_usage(handle, 2) < 200 ||
+			simpl_tag_usage(handle, 0) < 50)
+			r = -EFAULT;
+		usage = simpl_tag_usage(handle, 2);
+		a = m->realloc(handle, a, 1000);
+		if (!a || simpl_tag_usage(handle, 1) < 1000 || simpl_tag_usage(handle, 2) != usage)
+			r = -EFAULT;
+		m->free(handle, a);
+		m->free(handle, b);
+		m->free(handle, c);
+		if (simpl_tag_usage(handle, 0) || simpl_tag_usage(handle, 1) || simpl_tag_usage(handle, 2))
+			r = -EFAULT;
+
+		simpl_set_tag_budget(handle, 3, 1024);
+		a = simpl_malloc_tagged(handle, 512, 3);
+		if (!a || simpl_malloc_tagged(handle, 600, 3) || m->realloc(handle, a, 2048))
+			r = -EFAULT;
+		m->free(handle, a);
+		if (!(a = simpl_malloc_tagged(handle, 600, 3)))
+			r = -EFAULT;
+		m->free(handle, a);
+
+		mark = m->mark(handle);
+		if (!mark || !simpl_malloc_tagged(handle, 300, 1))
+			r = -ENOMEM;
+		m->release(handle, mark);
+		if (simpl_tag_usage(handle, 1) || simpl_tag_usage(handle, 3))
+			r = -EFAULT;
+	}
+	free(buffer);
+	return r;
+}
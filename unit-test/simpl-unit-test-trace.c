@@ -0,0 +1,86 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-trace.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+static size_t trace_events[simpl_trace_fail + 1];
+static void *trace_pool;
+
+static void trace_hook(void *simp, int event, size_t size, void *ptr, unsigned int fi)
+{
+	if (simp != trace_pool || event < 0 || event > simpl_trace_fail || !size ||
+		(event != simpl_trace_fail && !ptr))
+		return;
+	(void)fi;
+	trace_events[event]++;
+}
+
+int trace_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 16;
+	void *buffer, *p, *q;
+	size_t expect;
+	int i, r = 0;
+
+	if (!m->init || !m->malloc || !m->free || !m->realloc || !m->memalign)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	trace_pool = m->init(buffer, buffer_size);
+	memset(trace_events, 0, sizeof(trace_events));
+	simpl_set_trace_hook(trace_hook);
+
+	p = m->malloc(trace_pool, 100);
+	q = m->malloc(trace_pool, 200);
+	m->free(trace_pool, p);
+	p = m->realloc(trace_pool, q, 400);
+	q = m->memalign(trace_pool, 256, 256);
+	if (!p || !q || m->malloc(trace_pool, buffer_size))
+		r = -ENOMEM;
+	m->free(trace_pool, q);
+	m->free(trace_pool, p);
+	simpl_set_trace_hook(NULL);
+	m->malloc(trace_pool, 100); /* detached */
+
+#ifdef SIMPL_TRACE_HOOKS
+	expect = 1;
+#else
+	expect = 0;
+#endif//SIMPL_TRACE_HOOKS
+	for (i = simpl_trace_malloc; !r && i <= simpl_trace_fail; i++) {
+		if (i == simpl_trace_malloc || i == simpl_trace_free)
+			r = trace_events[i] == expect * (i == simpl_trace_malloc? 2: 3)? 0: -EFAULT;
+		else if (i == simpl_trace_split || i == simpl_trace_merge)
+			r = (trace_events[i] != 0) == (expect != 0)? 0: -EFAULT;
+		else
+			r = trace_events[i] == expect? 0: -EFAULT;
+	}
+	free(buffer);
+	return r;
+}
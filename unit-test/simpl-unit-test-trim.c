@@ -0,0 +1,78 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-trim.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+
+int trim_test(struct mempool *m)
+{
+	const size_t buffer_size = 1U << 18;
+	struct simpl_stats stats;
+	void *buffer, *handle, *mark, *p[8];
+	size_t new_size, trimmed, i;
+	int r = 0;
+
+	if (!m->init || !m->malloc || !m->free)
+		return -EFAULT;
+	buffer = malloc(buffer_size);
+	if (!buffer)
+		return -ENOMEM;
+	handle = m->init(buffer, buffer_size);
+	for (i = 0; i < 8; i++)
+		p[i] = m->malloc(handle, 4096);
+	if (!p[7])
+		r = -ENOMEM;
+	trimmed = simpl_trim(handle, &new_size); /* trailing free chunk */
+	if (!trimmed || new_size < 8 * 4096 || new_size + trimmed > buffer_size)
+		r = -EFAULT;
+	m->free(handle, p[7]);
+	m->free(handle, p[5]);
+	mark = simpl_mark(handle);
+	if (!mark || simpl_trim(handle, NULL))
+		r = -EFAULT;
+	simpl_release_to_mark(handle, mark);
+	trimmed = simpl_trim(handle, &new_size);
+	if (!r && (!trimmed || new_size > 7 * 4096 + 2048 || (uint8_t *)p[6] + 4096 > (uint8_t *)handle + new_size))
+		r = -EFAULT;
+	memset((uint8_t *)handle + new_size, 0xcc, buffer_size - new_size - ((uint8_t *)handle - (uint8_t *)buffer));
+
+	if (!(p[5] = m->malloc(handle, 2048)) || m->malloc(handle, 8192))
+		r = r? r: -EFAULT; /* hole of p[5] only */
+	for (i = 0; i < 7; i++)
+		m->free(handle, p[i]);
+	simpl_get_stats(handle, &stats);
+	if (!r && (stats.available + stats.deferred < new_size - 1024 || stats.available + stats.deferred > new_size))
+		r = -EFAULT;
+	trimmed = simpl_trim(handle, &new_size); /* only minimal first chunk left */
+	if (!r && (!trimmed || new_size > 1024 || simpl_trim(handle, NULL)))
+		r = -EFAULT;
+	simpl_reset(handle);
+	if (!r && (!(p[0] = m->malloc(handle, 24)) || m->malloc(handle, 512)))
+		r = -EFAULT;
+	free(buffer);
+	return r;
+}
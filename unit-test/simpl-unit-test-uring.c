@@ -0,0 +1,116 @@
+/** SIMPL Is Memory Pool Library (SIMPL)
+ *  @file simpl-unit-test-uring.c
+ *  @author Ozpin Lin <c20viisin@gmail.com>
+ *  @copyright Copyright (c) 2018, Ozpin Lin
+ *  @section LICENSE
+ *  Redistribution and use in source and binary forms, with or without modification,
+ *  are permitted provided that the following conditions are met:
+ *  1. Redistributions of source code must retain the above copyright notice,
+ *     and the entire permission notice in its entirety,
+ *     including the disclaimer of warranties.
+ *  2. Redistributions in binary form must reproduce the above copyright notice,
+ *     this list of conditions and the following disclaimer in the documentation
+ *     and/or other materials provided with the distribution.
+ *  3. The name of the author may not be inuse to endorse or promote products
+ *     derived from this software without specific prior written permission.
+ *  THIS SOFTWARE IS PROVIDED "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ *  INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND
+ *  FITNESS FOR A PARTICULAR PURPOSE, ALL OF WHICH ARE HEREBY DISCLAIMED.
+ *  IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *  SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF NOT ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include "simpl-unit-test.h"
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#ifndef SYS_io_uring_setup
+#define SYS_io_uring_setup (425)
+#endif//SYS_io_uring_setup
+#ifndef SYS_io_uring_register
+#define SYS_io_uring_register (427)
+#endif//SYS_io_uring_register
+#endif//__linux__
+
+/** @brief  Minimal io_uring, enough to register buffers.
+ *  @return File descriptor, negative if io_uring is not available. */
+static int uring_test_setup(void)
+{
+#if defined(__linux__)
+	uint32_t params[30] = {0}; /* struct io_uring_params */
+
+	return (int)syscall(SYS_io_uring_setup, 4, params);
+#else
+	return -1;
+#endif//__linux__
+}
+
+static void uring_test_close(int ring)
+{
+#if defined(__linux__)
+	if (ring >= 0)
+		close(ring);
+#else
+	(void)ring;
+#endif//__linux__
+}
+
+int uring_test(struct mempool *m)
+{
+	const size_t pool_size = 1U << 20, page = 4096;
+	struct simpl_uring_buffer b[3];
+	struct simpl_stats stats;
+	void *uring, *other;
+	int ring = uring_test_setup(), r = 0, i;
+
+	(void)m;
+	if (!(uring = simpl_uring_create(ring, pool_size))) {
+#if defined(__linux__)
+		r = ring < 0? -EFAULT: 0; /* RLIMIT_MEMLOCK may refuse registration */
+#endif//__linux__
+		uring_test_close(ring);
+		return r;
+	}
+	simpl_uring_get_stats(uring, &stats);
+	if (stats.available + 2 * page < pool_size * 254 / 256)
+		r = -EFAULT;
+	if (!r && (simpl_uring_malloc(uring, 1, &b[0]) || simpl_uring_malloc(uring, 10000, &b[1]) ||
+		simpl_uring_malloc(uring, page, &b[2]) || simpl_uring_malloc(uring, pool_size, &b[2]) != -ENOMEM))
+		r = -EFAULT;
+	for (i = 0; !r && i < 3; i++) {
+		if ((uintptr_t)b[i].data & (page - 1) || b[i].size & (page - 1) || b[i].index ||
+			(uint8_t *)b[i].data - (uint8_t *)b[0].data != (ptrdiff_t)(b[i].offset - b[0].offset) ||
+			b[i].offset + b[i].size > pool_size)
+			r = -EFAULT;
+		else
+			memset(b[i].data, i, b[i].size);
+	}
+	if (!r && (b[0].size != page || b[1].size != 3 * page || b[1].data != (uint8_t *)b[0].data + page))
+		r = -EFAULT;
+#if defined(__linux__)
+	if (!r && ring >= 0 && (other = simpl_uring_create(ring, pool_size))) { /* buffers of ring in use */
+		simpl_uring_destroy(other);
+		r = -EFAULT;
+	}
+#endif//__linux__
+	for (i = 0; i < 3; i++)
+		simpl_uring_free(uring, b[i].data);
+	simpl_uring_get_stats(uring, &stats);
+	if (!r && stats.largest_free != stats.available)
+		r = -EFAULT;
+	simpl_uring_destroy(uring);
+	if (!r && ring >= 0) { /* unregistered by destroy */
+		if (!(other = simpl_uring_create(ring, pool_size)))
+			r = -EFAULT;
+		simpl_uring_destroy(other);
+	}
+	uring_test_close(ring);
+	return r;
+}
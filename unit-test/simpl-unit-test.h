@@ -27,15 +27,21 @@
 #define _SIMPL_UNIT_TEST_H
 
 #include <stddef.h>
+#include "simpl.h"
 
 struct mempool {
 	size_t buffer_size;
 	void *buffer;
 	void *(*init)(void *, size_t);
+	void *(*init_ex)(void *, size_t, unsigned int);
 	void *(*malloc)(void *, size_t);
 	void (*free)(void *, void *);
 	void *(*realloc)(void *, void *, size_t);
 	void *(*memalign)(void *, size_t, size_t);
+	void (*reset)(void *);
+	void *(*mark)(void *);
+	void (*release)(void *, void *);
+	void (*stats)(void *, struct simpl_stats *);
 	void (*dump)(void *);
 	void *handle;
 	size_t pool_overhead;